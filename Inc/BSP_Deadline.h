@@ -0,0 +1,99 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 1995 - 2022 SEGGER Microcontroller GmbH                  *
+*                                                                    *
+*       Internet: segger.com  Support: support_embos@segger.com      *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       embOS * Real time operating system                           *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product or a real-time            *
+*       operating system for in-house use.                           *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       OS version: V5.18.0.0                                        *
+*                                                                    *
+**********************************************************************
+
+-------------------------- END-OF-HEADER -----------------------------
+File    : BSP_Deadline.h
+Purpose : High-resolution one-shot deadlines on the machine timer.
+*/
+
+#ifndef BSP_DEADLINE_H
+#define BSP_DEADLINE_H
+
+#include "RTOS.h"
+#include "RTOSInit.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+
+//
+// Task event used by BSP_DEADLINE_Delay_us() to wake the calling task.
+//
+#ifndef   BSP_DEADLINE_TASKEVENT
+  #define BSP_DEADLINE_TASKEVENT  (1u << 7)
+#endif
+
+/*********************************************************************
+*
+*       Types, global
+*
+**********************************************************************
+*/
+
+typedef void BSP_DEADLINE_ROUTINE(void* pContext);
+
+typedef struct BSP_DEADLINE_STRUCT BSP_DEADLINE;
+struct BSP_DEADLINE_STRUCT {
+  BSP_DEADLINE*         pNext;
+  OS_U64                Expire;     // Absolute machine timer value
+  BSP_DEADLINE_ROUTINE* pfRoutine;  // Called from ISR_M_Timer() when the deadline expires
+  void*                 pContext;
+  OS_BOOL               Active;
+};
+
+/*********************************************************************
+*
+*       API functions / Function prototypes
+*
+**********************************************************************
+*/
+#if defined(__cplusplus)
+  extern "C" {
+#endif
+
+#if (DEADLINE_SERVICE != 0)
+OS_U64  BSP_DEADLINE_GetTime         (void);
+OS_U64  BSP_DEADLINE_Convertus2Cycles(OS_U32 us);
+void    BSP_DEADLINE_Start           (BSP_DEADLINE* pDeadline, OS_U64 Expire, BSP_DEADLINE_ROUTINE* pfRoutine, void* pContext);
+void    BSP_DEADLINE_Start_us        (BSP_DEADLINE* pDeadline, OS_U32 us, BSP_DEADLINE_ROUTINE* pfRoutine, void* pContext);
+void    BSP_DEADLINE_Stop            (BSP_DEADLINE* pDeadline);
+OS_BOOL BSP_DEADLINE_IsActive        (const BSP_DEADLINE* pDeadline);
+void    BSP_DEADLINE_Delay_us        (OS_U32 us);
+void    BSP_DEADLINE_DelayUntil      (OS_U64 Expire);
+void    BSP_DEADLINE_Handle          (void);
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif  // BSP_DEADLINE_H
+
+/*************************** End of file ****************************/
@@ -0,0 +1,118 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 1995 - 2022 SEGGER Microcontroller GmbH                  *
+*                                                                    *
+*       Internet: segger.com  Support: support_embos@segger.com      *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       embOS * Real time operating system                           *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product or a real-time            *
+*       operating system for in-house use.                           *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       OS version: V5.18.0.0                                        *
+*                                                                    *
+**********************************************************************
+
+-------------------------- END-OF-HEADER -----------------------------
+File    : BSP_DeferredWork.h
+Purpose : Deferred interrupt work, executed by a worker task.
+*/
+
+#ifndef BSP_DEFERREDWORK_H
+#define BSP_DEFERREDWORK_H
+
+#include "RTOS.h"
+#include "RTOSInit.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+
+//
+// Number of work items which may be pending. Must be a power of 2.
+//
+#ifndef   BSP_DEFER_NUM_ITEMS
+  #define BSP_DEFER_NUM_ITEMS   (32u)
+#endif
+
+//
+// Number of work items the worker task executes before it yields to
+// other ready tasks of the same priority.
+//
+#ifndef   BSP_DEFER_BATCH_SIZE
+  #define BSP_DEFER_BATCH_SIZE  (8u)
+#endif
+
+#ifndef   BSP_DEFER_STACK_SIZE
+  #define BSP_DEFER_STACK_SIZE  (256u)  // Stack size of the worker task in words
+#endif
+
+//
+// Task event used to wake the worker task.
+//
+#ifndef   BSP_DEFER_TASKEVENT
+  #define BSP_DEFER_TASKEVENT   (1u << 0)
+#endif
+
+#if ((BSP_DEFER_NUM_ITEMS & (BSP_DEFER_NUM_ITEMS - 1u)) != 0u)
+  #error "BSP_DEFER_NUM_ITEMS must be a power of 2"
+#endif
+
+/*********************************************************************
+*
+*       Types, global
+*
+**********************************************************************
+*/
+
+typedef void BSP_DEFER_ROUTINE(void* pContext);
+
+typedef struct {
+  OS_U32 NumPosted;      // Work items accepted by BSP_DEFER_Post()
+  OS_U32 NumExecuted;    // Work items executed by the worker task
+  OS_U32 NumOverflows;   // Work items rejected because the queue was full
+  OS_U32 MaxDepth;       // Maximum number of pending work items
+  OS_U32 LatencyMax;     // Post to start of execution, in CPU cycles
+  OS_U32 LatencyMean;    // Set by BSP_DEFER_GetStat()
+  OS_U64 LatencySum;
+} BSP_DEFER_STAT;
+
+/*********************************************************************
+*
+*       API functions / Function prototypes
+*
+**********************************************************************
+*/
+#if defined(__cplusplus)
+  extern "C" {
+#endif
+
+#if (DEFERRED_WORK != 0)
+void BSP_DEFER_Init     (OS_PRIO Priority);
+int  BSP_DEFER_Post     (BSP_DEFER_ROUTINE* pfRoutine, void* pContext);
+void BSP_DEFER_GetStat  (BSP_DEFER_STAT* pStat);
+void BSP_DEFER_ResetStat(void);
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif  // BSP_DEFERREDWORK_H
+
+/*************************** End of file ****************************/
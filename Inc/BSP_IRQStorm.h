@@ -0,0 +1,138 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 1995 - 2022 SEGGER Microcontroller GmbH                  *
+*                                                                    *
+*       Internet: segger.com  Support: support_embos@segger.com      *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       embOS * Real time operating system                           *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product or a real-time            *
+*       operating system for in-house use.                           *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       OS version: V5.18.0.0                                        *
+*                                                                    *
+**********************************************************************
+
+-------------------------- END-OF-HEADER -----------------------------
+File    : BSP_IRQStorm.h
+Purpose : Detection and rate limiting of global interrupt storms.
+*/
+
+#ifndef BSP_IRQSTORM_H
+#define BSP_IRQSTORM_H
+
+#include "RTOS.h"
+#include "RTOSInit.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+
+//
+// A global IRQ which occurs more than BSP_STORM_MAX_IRQS times within
+// BSP_STORM_WINDOW_US is considered a storm and masked.
+//
+#ifndef   BSP_STORM_MAX_IRQS
+  #define BSP_STORM_MAX_IRQS      (1000u)
+#endif
+
+#ifndef   BSP_STORM_WINDOW_US
+  #define BSP_STORM_WINDOW_US     (10000u)
+#endif
+
+//
+// Masked IRQs are polled every BSP_STORM_POLL_PERIOD ticks and unmasked
+// after a backoff period, which starts at BSP_STORM_MIN_BACKOFF ticks
+// and doubles up to BSP_STORM_MAX_BACKOFF ticks for each storm which
+// recurs within its previous backoff period after unmasking.
+//
+#ifndef   BSP_STORM_POLL_PERIOD
+  #define BSP_STORM_POLL_PERIOD   (1)
+#endif
+
+#ifndef   BSP_STORM_MIN_BACKOFF
+  #define BSP_STORM_MIN_BACKOFF   (10)
+#endif
+
+#ifndef   BSP_STORM_MAX_BACKOFF
+  #define BSP_STORM_MAX_BACKOFF   (1000)
+#endif
+
+#ifndef   BSP_STORM_LOG_SIZE
+  #define BSP_STORM_LOG_SIZE      (16u)  // Number of storm events kept in the log
+#endif
+
+#ifndef   BSP_STORM_STACK_SIZE
+  #define BSP_STORM_STACK_SIZE    (256u)  // Stack size of the poll task in words
+#endif
+
+//
+// Task event used to wake the poll task.
+//
+#ifndef   BSP_STORM_TASKEVENT
+  #define BSP_STORM_TASKEVENT     (1u << 0)
+#endif
+
+/*********************************************************************
+*
+*       Defines, fixed
+*
+**********************************************************************
+*/
+#define BSP_STORM_EVENT_MASKED    (0u)  // Storm detected, IRQ masked and polled
+#define BSP_STORM_EVENT_UNMASKED  (1u)  // Backoff period elapsed, IRQ unmasked
+
+/*********************************************************************
+*
+*       Types, global
+*
+**********************************************************************
+*/
+
+typedef struct {
+  OS_TIME Time;      // embOS time of the event
+  OS_U16  IRQIndex;
+  OS_U8   Event;     // BSP_STORM_EVENT_MASKED or BSP_STORM_EVENT_UNMASKED
+  OS_U32  NumIRQs;   // IRQs within the window which caused the storm
+  OS_TIME Backoff;   // Backoff period in ticks
+} BSP_STORM_LOG_ENTRY;
+
+/*********************************************************************
+*
+*       API functions / Function prototypes
+*
+**********************************************************************
+*/
+#if defined(__cplusplus)
+  extern "C" {
+#endif
+
+#if (IRQ_STORM_DETECTION != 0)
+void    BSP_STORM_Init    (OS_PRIO Priority);
+void    BSP_STORM_Count   (OS_U32 IRQIndex);
+OS_BOOL BSP_STORM_IsMasked(OS_U32 IRQIndex);
+OS_U32  BSP_STORM_GetLog  (BSP_STORM_LOG_ENTRY* paEntry, OS_U32 MaxEntries);
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif  // BSP_IRQSTORM_H
+
+/*************************** End of file ****************************/
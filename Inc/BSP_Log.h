@@ -0,0 +1,152 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 1995 - 2022 SEGGER Microcontroller GmbH                  *
+*                                                                    *
+*       Internet: segger.com  Support: support_embos@segger.com      *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       embOS * Real time operating system                           *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product or a real-time            *
+*       operating system for in-house use.                           *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       OS version: V5.18.0.0                                        *
+*                                                                    *
+**********************************************************************
+
+-------------------------- END-OF-HEADER -----------------------------
+File    : BSP_Log.h
+Purpose : Deferred logging, output of _write() via a lock-free ring.
+*/
+
+#ifndef BSP_LOG_H
+#define BSP_LOG_H
+
+#include "RTOS.h"
+#include "RTOSInit.h"
+#include "BSP_UART.h"
+
+/*********************************************************************
+*
+*       Defines, fixed
+*
+**********************************************************************
+*/
+#define BSP_LOG_DROP_NEWEST  (0)  // A write which does not fit into the ring is discarded
+#define BSP_LOG_DROP_OLDEST  (1)  // The oldest pending chunks are discarded to make room
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+
+//
+// Number of chunks in the log ring. Must be a power of 2.
+//
+#ifndef   BSP_LOG_NUM_CHUNKS
+  #define BSP_LOG_NUM_CHUNKS   (64u)
+#endif
+
+//
+// Payload of a chunk in bytes. A write occupies as many consecutive
+// chunks as needed, hence a chunk of 4 words in total suits short
+// log lines.
+//
+#ifndef   BSP_LOG_CHUNK_SIZE
+  #define BSP_LOG_CHUNK_SIZE   (24u)
+#endif
+
+//
+// Overflow policy, BSP_LOG_DROP_NEWEST or BSP_LOG_DROP_OLDEST.
+//
+#ifndef   BSP_LOG_POLICY
+  #define BSP_LOG_POLICY       (BSP_LOG_DROP_NEWEST)
+#endif
+
+//
+// UART the log ring is flushed to. It must be initialized by the
+// application via BSP_UART_Init() and must not be used by embOSView.
+//
+#ifndef   BSP_LOG_UART
+  #define BSP_LOG_UART         (OS_UART)
+#endif
+
+#ifndef   BSP_LOG_STACK_SIZE
+  #define BSP_LOG_STACK_SIZE   (128u)  // Stack size of the flush task in words
+#endif
+
+//
+// Task event used to wake the flush task.
+//
+#ifndef   BSP_LOG_TASKEVENT
+  #define BSP_LOG_TASKEVENT    (1u << 0)
+#endif
+
+#if ((BSP_LOG_NUM_CHUNKS & (BSP_LOG_NUM_CHUNKS - 1u)) != 0u)
+  #error "BSP_LOG_NUM_CHUNKS must be a power of 2"
+#endif
+
+#if ((BSP_LOG_POLICY != BSP_LOG_DROP_NEWEST) && (BSP_LOG_POLICY != BSP_LOG_DROP_OLDEST))
+  #error "BSP_LOG_POLICY must be BSP_LOG_DROP_NEWEST or BSP_LOG_DROP_OLDEST"
+#endif
+
+#if (DEFERRED_LOG != 0) && defined(OS_VIEW_IFSELECT)
+  #if ((OS_VIEW_IFSELECT == OS_VIEW_IF_UART) && (BSP_LOG_UART == OS_UART))
+    #error "BSP_LOG_UART must not be the UART used by embOSView"
+  #endif
+#endif
+
+/*********************************************************************
+*
+*       Types, global
+*
+**********************************************************************
+*/
+
+typedef struct {
+  OS_U32 NumBytes;         // Bytes accepted by BSP_LOG_Write()
+  OS_U32 NumFlushed;       // Bytes passed to the UART
+  OS_U32 NumOverflows;     // Writes which did not fit into the ring
+  OS_U32 NumDroppedBytes;  // Bytes of writes discarded with BSP_LOG_DROP_NEWEST
+  OS_U32 NumDiscarded;     // Chunks discarded with BSP_LOG_DROP_OLDEST
+  OS_U32 MaxDepth;         // Maximum number of pending chunks
+} BSP_LOG_STAT;
+
+/*********************************************************************
+*
+*       API functions / Function prototypes
+*
+**********************************************************************
+*/
+#if defined(__cplusplus)
+  extern "C" {
+#endif
+
+#if (DEFERRED_LOG != 0)
+void BSP_LOG_Init     (OS_PRIO Priority);
+int  BSP_LOG_Write    (const char* pData, int NumBytes);
+void BSP_LOG_OnIdle   (void);
+void BSP_LOG_GetStat  (BSP_LOG_STAT* pStat);
+void BSP_LOG_ResetStat(void);
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif  // BSP_LOG_H
+
+/*************************** End of file ****************************/
@@ -0,0 +1,107 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 1995 - 2022 SEGGER Microcontroller GmbH                  *
+*                                                                    *
+*       Internet: segger.com  Support: support_embos@segger.com      *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       embOS * Real time operating system                           *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product or a real-time            *
+*       operating system for in-house use.                           *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       OS version: V5.18.0.0                                        *
+*                                                                    *
+**********************************************************************
+
+-------------------------- END-OF-HEADER -----------------------------
+File    : BSP_SlackTimer.h
+Purpose : Software timers with per-timer slack, coalesced into few wakeups.
+*/
+
+#ifndef BSP_SLACKTIMER_H
+#define BSP_SLACKTIMER_H
+
+#include "RTOS.h"
+#include "RTOSInit.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+
+//
+// Task event used by BSP_SLACK_Delay() to wake the calling task.
+//
+#ifndef   BSP_SLACK_TASKEVENT
+  #define BSP_SLACK_TASKEVENT  (1u << 6)
+#endif
+
+/*********************************************************************
+*
+*       Types, global
+*
+**********************************************************************
+*/
+
+typedef struct BSP_SLACK_TIMER_STRUCT BSP_SLACK_TIMER;
+struct BSP_SLACK_TIMER_STRUCT {
+  BSP_SLACK_TIMER*     pNext;
+  BSP_SLACK_TIMER*     pNextExpired;    // Link of the expired timers of one wakeup
+  OS_TIME              Earliest;        // Absolute tick at which the timer may expire
+  OS_TIME              Latest;          // Absolute tick at which the timer must expire
+  OS_TIME              Period;
+  OS_TIME              Slack;
+  OS_ROUTINE_VOID_PTR* pfTimerRoutine;  // Same signature as for OS_TIMER_EX
+  void*                pData;
+  OS_BOOL              Active;
+  OS_BOOL              Pending;         // Expired, timer routine not yet called
+};
+
+typedef struct {
+  OS_U32 NumWakeups;  // Number of times the service timer expired
+  OS_U32 NumExpired;  // Number of timers which expired
+} BSP_SLACK_STAT;
+
+/*********************************************************************
+*
+*       API functions / Function prototypes
+*
+**********************************************************************
+*/
+#if defined(__cplusplus)
+  extern "C" {
+#endif
+
+#if (SLACK_TIMER != 0)
+void    BSP_SLACK_Init     (void);
+void    BSP_SLACK_Create   (BSP_SLACK_TIMER* pTimer, OS_ROUTINE_VOID_PTR* pfTimerRoutine, OS_TIME Period, OS_TIME Slack, void* pData);
+void    BSP_SLACK_Start    (BSP_SLACK_TIMER* pTimer);
+void    BSP_SLACK_Stop     (BSP_SLACK_TIMER* pTimer);
+void    BSP_SLACK_Restart  (BSP_SLACK_TIMER* pTimer);
+void    BSP_SLACK_SetPeriod(BSP_SLACK_TIMER* pTimer, OS_TIME Period, OS_TIME Slack);
+OS_BOOL BSP_SLACK_GetStatus(const BSP_SLACK_TIMER* pTimer);
+void    BSP_SLACK_Delay    (OS_TIME Period, OS_TIME Slack);
+void    BSP_SLACK_GetStat  (BSP_SLACK_STAT* pStat);
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif  // BSP_SLACKTIMER_H
+
+/*************************** End of file ****************************/
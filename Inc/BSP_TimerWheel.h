@@ -0,0 +1,103 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 1995 - 2022 SEGGER Microcontroller GmbH                  *
+*                                                                    *
+*       Internet: segger.com  Support: support_embos@segger.com      *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       embOS * Real time operating system                           *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product or a real-time            *
+*       operating system for in-house use.                           *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       OS version: V5.18.0.0                                        *
+*                                                                    *
+**********************************************************************
+
+-------------------------- END-OF-HEADER -----------------------------
+File    : BSP_TimerWheel.h
+Purpose : Hierarchical timing wheel for large numbers of software timers.
+*/
+
+#ifndef BSP_TIMERWHEEL_H
+#define BSP_TIMERWHEEL_H
+
+#include "RTOS.h"
+#include "RTOSInit.h"
+
+/*********************************************************************
+*
+*       Defines, fixed
+*
+**********************************************************************
+*/
+#define BSP_TWHEEL_SLOT_BITS   (6)                              // 64 slots per level
+#define BSP_TWHEEL_NUM_SLOTS   (1u << BSP_TWHEEL_SLOT_BITS)
+#define BSP_TWHEEL_NUM_LEVELS  (4)                              // 4 levels cover 2^24 ticks without re-queuing
+#define BSP_TWHEEL_MAX_PERIOD  (0x7FFFFFFF)
+
+/*********************************************************************
+*
+*       Types, global
+*
+**********************************************************************
+*/
+
+typedef struct BSP_TWHEEL_LINK_STRUCT BSP_TWHEEL_LINK;
+struct BSP_TWHEEL_LINK_STRUCT {
+  BSP_TWHEEL_LINK* pNext;
+  BSP_TWHEEL_LINK* pPrev;
+};
+
+typedef struct BSP_TWHEEL_TIMER_STRUCT BSP_TWHEEL_TIMER;
+struct BSP_TWHEEL_TIMER_STRUCT {
+  BSP_TWHEEL_LINK      Link;            // Must be the first member
+  OS_U32               Expire;          // Absolute wheel tick of expiration
+  OS_TIME              Period;
+  OS_ROUTINE_VOID_PTR* pfTimerRoutine;  // Same signature as for OS_TIMER_EX
+  void*                pData;
+  OS_BOOL              Active;
+};
+
+/*********************************************************************
+*
+*       API functions / Function prototypes
+*
+**********************************************************************
+*/
+#if defined(__cplusplus)
+  extern "C" {
+#endif
+
+#if (TIMER_WHEEL != 0)
+void    BSP_TWHEEL_Init              (void);
+void    BSP_TWHEEL_Create            (BSP_TWHEEL_TIMER* pTimer, OS_ROUTINE_VOID_PTR* pfTimerRoutine, OS_TIME Period, void* pData);
+void    BSP_TWHEEL_Start             (BSP_TWHEEL_TIMER* pTimer);
+void    BSP_TWHEEL_Stop              (BSP_TWHEEL_TIMER* pTimer);
+void    BSP_TWHEEL_Restart           (BSP_TWHEEL_TIMER* pTimer);
+void    BSP_TWHEEL_SetPeriod         (BSP_TWHEEL_TIMER* pTimer, OS_TIME Period);
+OS_TIME BSP_TWHEEL_GetPeriod         (const BSP_TWHEEL_TIMER* pTimer);
+OS_TIME BSP_TWHEEL_GetRemainingPeriod(const BSP_TWHEEL_TIMER* pTimer);
+OS_BOOL BSP_TWHEEL_GetStatus         (const BSP_TWHEEL_TIMER* pTimer);
+OS_U32  BSP_TWHEEL_GetNumActive      (void);
+OS_TIME BSP_TWHEEL_GetNumIdleTicks   (void);
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif  // BSP_TIMERWHEEL_H
+
+/*************************** End of file ****************************/
@@ -0,0 +1,197 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 1995 - 2022 SEGGER Microcontroller GmbH                  *
+*                                                                    *
+*       Internet: segger.com  Support: support_embos@segger.com      *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       embOS * Real time operating system                           *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product or a real-time            *
+*       operating system for in-house use.                           *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       OS version: V5.18.0.0                                        *
+*                                                                    *
+**********************************************************************
+
+-------------------------- END-OF-HEADER -----------------------------
+File    : BSP_Timestamp.h
+Purpose : Timestamp sources of the AGRV2K (RV32).
+
+Additional information:
+  Two time sources are available:
+    - The machine timer MTIME (memory mapped, 64 bit), which is the
+      time base of the system tick and the deadline service.
+    - The cycle counter CSR mcycle, read via rdcycle/rdcycleh.
+  On RV32, a 64-bit value is read with two 32-bit loads. A carry from
+  the low into the high word between both loads yields a value which
+  is off by 2^32. The routines in this file read the high word twice
+  and retry if it changed, which is lock-free and safe to use from
+  tasks and interrupts without disabling interrupts.
+
+  Cost per call in instructions executed without retry (wait states
+  of the CLINT bus accesses not included):
+    BSP_TS_GetCycles()    1  (rdcycle)
+    BSP_TS_GetCycles64()  5  (rdcycleh, rdcycle, rdcycleh, compare)
+    BSP_TS_GetMTime()     5  (3 loads from the CLINT, compare)
+    BSP_TS_SetMTimeCmp()  3  (3 stores to the CLINT)
+  A retry is required only if the low word wraps between the loads,
+  which happens at most once every 2^32 counter cycles.
+*/
+
+#ifndef BSP_TIMESTAMP_H
+#define BSP_TIMESTAMP_H
+
+#include "RTOS.h"
+#include "board.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+
+//
+// Use the time CSR (rdtime/rdtimeh) instead of memory mapped loads
+// in BSP_TS_GetTime(). Only enable if the core implements the time
+// CSR, otherwise rdtime raises an illegal instruction exception.
+//
+#ifndef   BSP_TS_USE_TIME_CSR
+  #define BSP_TS_USE_TIME_CSR  (0)
+#endif
+
+/*********************************************************************
+*
+*       Defines, fixed
+*
+**********************************************************************
+*/
+#define BSP_TS_MTIME_FREQ    (BOARD_PLL_FREQUENCY)  // Frequency of MTIME in Hz
+#define BSP_TS_CYCLE_FREQ    (BOARD_PLL_FREQUENCY)  // Frequency of mcycle in Hz
+
+#define BSP_TS_MTIME_LO      (*(volatile OS_U32*)(0x200BFF8u))  // Timer counter register, low word
+#define BSP_TS_MTIME_HI      (*(volatile OS_U32*)(0x200BFFCu))  // Timer counter register, high word
+#define BSP_TS_MTIMECMP_LO   (*(volatile OS_U32*)(0x2004000u))  // Timer compare register, low word
+#define BSP_TS_MTIMECMP_HI   (*(volatile OS_U32*)(0x2004004u))  // Timer compare register, high word
+
+/*********************************************************************
+*
+*       API functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       BSP_TS_GetCycles()
+*
+*  Function description
+*    Returns the low word of the cycle counter. This is the cheapest
+*    timestamp and sufficient for differences below 2^32 cycles.
+*/
+static inline OS_U32 BSP_TS_GetCycles(void) {
+  OS_U32 Cycles;
+
+  __asm volatile ("rdcycle %0" : "=r" (Cycles));
+  return Cycles;
+}
+
+/*********************************************************************
+*
+*       BSP_TS_GetCycles64()
+*
+*  Function description
+*    Returns the 64-bit cycle counter without tearing.
+*/
+static inline OS_U64 BSP_TS_GetCycles64(void) {
+  OS_U32 Hi;
+  OS_U32 Lo;
+  OS_U32 Hi2;
+
+  do {
+    __asm volatile ("rdcycleh %0" : "=r" (Hi));
+    __asm volatile ("rdcycle  %0" : "=r" (Lo));
+    __asm volatile ("rdcycleh %0" : "=r" (Hi2));
+  } while (Hi != Hi2);
+  return ((OS_U64)Hi << 32) | Lo;
+}
+
+/*********************************************************************
+*
+*       BSP_TS_GetMTime()
+*
+*  Function description
+*    Returns the 64-bit machine timer value without tearing.
+*/
+static inline OS_U64 BSP_TS_GetMTime(void) {
+  OS_U32 Hi;
+  OS_U32 Lo;
+  OS_U32 Hi2;
+
+  do {
+    Hi  = BSP_TS_MTIME_HI;
+    Lo  = BSP_TS_MTIME_LO;
+    Hi2 = BSP_TS_MTIME_HI;
+  } while (Hi != Hi2);
+  return ((OS_U64)Hi << 32) | Lo;
+}
+
+/*********************************************************************
+*
+*       BSP_TS_SetMTimeCmp()
+*
+*  Function description
+*    Writes the 64-bit machine timer compare register without causing
+*    a spurious interrupt.
+*
+*  Additional information
+*    The low word is set to its maximum first, so that the intermediate
+*    value after writing the high word is never below the new compare
+*    value.
+*/
+static inline void BSP_TS_SetMTimeCmp(OS_U64 Compare) {
+  BSP_TS_MTIMECMP_LO = 0xFFFFFFFFu;
+  BSP_TS_MTIMECMP_HI = (OS_U32)(Compare >> 32);
+  BSP_TS_MTIMECMP_LO = (OS_U32)Compare;
+}
+
+/*********************************************************************
+*
+*       BSP_TS_GetTime()
+*
+*  Function description
+*    Returns the machine timer value, either via the time CSR or via
+*    the memory mapped MTIME register.
+*/
+static inline OS_U64 BSP_TS_GetTime(void) {
+#if (BSP_TS_USE_TIME_CSR != 0)
+  OS_U32 Hi;
+  OS_U32 Lo;
+  OS_U32 Hi2;
+
+  do {
+    __asm volatile ("rdtimeh %0" : "=r" (Hi));
+    __asm volatile ("rdtime  %0" : "=r" (Lo));
+    __asm volatile ("rdtimeh %0" : "=r" (Hi2));
+  } while (Hi != Hi2);
+  return ((OS_U64)Hi << 32) | Lo;
+#else
+  return BSP_TS_GetMTime();
+#endif
+}
+
+#endif  // BSP_TIMESTAMP_H
+
+/*************************** End of file ****************************/
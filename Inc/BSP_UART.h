@@ -33,6 +33,8 @@ Purpose : Header file for UART related BSP functions.
 #ifndef BSP_UART_H
 #define BSP_UART_H
 
+#include "RTOS.h"
+
 /*********************************************************************
 *
 *       Defines
@@ -40,14 +42,83 @@ Purpose : Header file for UART related BSP functions.
 **********************************************************************
 */
 
-#ifndef OS_UATT
+#ifndef OS_UART
 #define OS_UART 1
 #endif
 
+//
+// Number of UART units supported by the driver, units 0 to n-1.
+//
+#ifndef BSP_UART_NUM_UNITS
+  #define BSP_UART_NUM_UNITS  (2u)
+#endif
+
+//
+// Units whose interrupt handler UART<n>_isr is defined by the driver,
+// one bit per unit. Only used without EXTEND_GLOBAL_ISR_CONTEXT, which
+// installs the handler of each initialized unit instead. Defaults to
+// OS_UART only, so the driver does not define the handlers of units
+// the application serves otherwise.
+//
+#ifndef BSP_UART_ISR_UNITS
+  #define BSP_UART_ISR_UNITS  (1u << OS_UART)
+#endif
+
+#if (OS_UART >= BSP_UART_NUM_UNITS)
+  #error "OS_UART must be below BSP_UART_NUM_UNITS"
+#endif
+
+#if ((BSP_UART_ISR_UNITS >> BSP_UART_NUM_UNITS) != 0u)
+  #error "BSP_UART_ISR_UNITS selects units beyond BSP_UART_NUM_UNITS"
+#endif
+
 #ifndef OS_BAUDRATE
 #define OS_BAUDRATE 115200
 #endif
 
+//
+// Size of the TX ring of BSP_UART_Write() in bytes. Must be a power of 2.
+//
+#ifndef BSP_UART_TX_BUFFER_SIZE
+  #define BSP_UART_TX_BUFFER_SIZE  (256u)
+#endif
+
+//
+// Size of the RX ring of BSP_UART_Read() in bytes. Must be a power of 2.
+//
+#ifndef BSP_UART_RX_BUFFER_SIZE
+  #define BSP_UART_RX_BUFFER_SIZE  (256u)
+#endif
+
+//
+// RX FIFO level which raises the RX interrupt, see BSP_UART_RX_LEVEL_*.
+// Higher levels cause fewer interrupts, but leave less time to serve
+// the interrupt before the FIFO overruns.
+//
+#ifndef BSP_UART_RX_LEVEL
+  #define BSP_UART_RX_LEVEL  (BSP_UART_RX_LEVEL_HALF)
+#endif
+
+#if ((BSP_UART_TX_BUFFER_SIZE & (BSP_UART_TX_BUFFER_SIZE - 1u)) != 0u)
+  #error "BSP_UART_TX_BUFFER_SIZE must be a power of 2"
+#endif
+
+#if ((BSP_UART_RX_BUFFER_SIZE & (BSP_UART_RX_BUFFER_SIZE - 1u)) != 0u)
+  #error "BSP_UART_RX_BUFFER_SIZE must be a power of 2"
+#endif
+
+#if (BSP_UART_RX_LEVEL > BSP_UART_RX_LEVEL_7_8)
+  #error "BSP_UART_RX_LEVEL must be one of BSP_UART_RX_LEVEL_*"
+#endif
+
+//
+// Name of the interrupt handler of a UART unit, as referenced by the
+// interrupt handler tables. Only defined without EXTEND_GLOBAL_ISR_CONTEXT,
+// else the handler is installed with its unit as context.
+//
+#define BSP_UART_IRQHandler_(Unit)  UART##Unit##_isr
+#define BSP_UART_IRQHandler(Unit)   BSP_UART_IRQHandler_(Unit)
+
 //
 // In order to avoid warnings for unused parameters.
 //
@@ -73,6 +144,15 @@ Purpose : Header file for UART related BSP functions.
 //
 #define BSP_UART_STOP_BITS_1  (1u)
 
+//
+// RX FIFO trigger levels
+//
+#define BSP_UART_RX_LEVEL_1_8   (0u)
+#define BSP_UART_RX_LEVEL_1_4   (1u)
+#define BSP_UART_RX_LEVEL_HALF  (2u)
+#define BSP_UART_RX_LEVEL_3_4   (3u)
+#define BSP_UART_RX_LEVEL_7_8   (4u)
+
 //
 // Compatibility macros for old names.
 // Use BSP_UART_* defines in new code.
@@ -91,6 +171,17 @@ Purpose : Header file for UART related BSP functions.
 typedef void BSP_UART_RX_CB(unsigned int Unit, unsigned char Data);
 typedef int  BSP_UART_TX_CB(unsigned int Unit);
 
+typedef struct {
+  unsigned long NumTxBytes;        // Bytes written to the TX FIFO
+  unsigned long NumTxInts;         // TX interrupts
+  unsigned long NumRxBytes;        // Bytes read from the RX FIFO
+  unsigned long NumRxDropped;      // Bytes dropped because the RX ring was full
+  unsigned long NumOverrunErrors;  // Interrupts which reported an RX FIFO overrun
+  unsigned long NumFramingErrors;  // Interrupts which reported a framing error
+  unsigned long NumParityErrors;   // Interrupts which reported a parity error
+  unsigned long NumBreaks;         // Interrupts which reported a break condition
+} BSP_UART_STAT;
+
 /*********************************************************************
 *
 *       API functions / Function prototypes
@@ -101,12 +192,18 @@ typedef int  BSP_UART_TX_CB(unsigned int Unit);
   extern "C" {
 #endif
 
-void BSP_UART_DeInit          (unsigned int Unit);
-void BSP_UART_Init            (unsigned int Unit, unsigned long Baudrate, unsigned char NumDataBits, unsigned char Parity, unsigned char NumStopBits);
-void BSP_UART_SetBaudrate     (unsigned int Unit, unsigned long Baudrate);
-void BSP_UART_SetReadCallback (unsigned int Unit, BSP_UART_RX_CB* pf);
-void BSP_UART_SetWriteCallback(unsigned int Unit, BSP_UART_TX_CB* pf);
-void BSP_UART_Write1          (unsigned int Unit, unsigned char Data);
+void         BSP_UART_IRQHandler(OS_UART)(void);
+void         BSP_UART_DeInit          (unsigned int Unit);
+void         BSP_UART_Init            (unsigned int Unit, unsigned long Baudrate, unsigned char NumDataBits, unsigned char Parity, unsigned char NumStopBits);
+void         BSP_UART_SetBaudrate     (unsigned int Unit, unsigned long Baudrate);
+void         BSP_UART_SetReadCallback (unsigned int Unit, BSP_UART_RX_CB* pf);
+void         BSP_UART_SetWriteCallback(unsigned int Unit, BSP_UART_TX_CB* pf);
+unsigned int BSP_UART_Write           (unsigned int Unit, const unsigned char* pData, unsigned int NumBytes);
+int          BSP_UART_WriteV          (unsigned int Unit, const OS_QUEUE_SRCLIST* paSrc, unsigned int NumSrc, OS_EVENT* pEvent);
+void         BSP_UART_Write1          (unsigned int Unit, unsigned char Data);
+unsigned int BSP_UART_Read            (unsigned int Unit, unsigned char* pData, unsigned int NumBytes);
+void         BSP_UART_GetStat         (unsigned int Unit, BSP_UART_STAT* pStat);
+void         BSP_UART_ResetStat       (unsigned int Unit);
 
 #if defined(__cplusplus)
 }
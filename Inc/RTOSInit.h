@@ -0,0 +1,399 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 1995 - 2022 SEGGER Microcontroller GmbH                  *
+*                                                                    *
+*       Internet: segger.com  Support: support_embos@segger.com      *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       embOS * Real time operating system                           *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product or a real-time            *
+*       operating system for in-house use.                           *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       OS version: V5.18.0.0                                        *
+*                                                                    *
+**********************************************************************
+
+-------------------------- END-OF-HEADER -----------------------------
+File    : RTOSInit.h
+Purpose : Configuration and API of the optional features implemented
+          in the embOS hardware initialization (RTOSInit_AGRV2K.c).
+*/
+
+#ifndef RTOSINIT_H
+#define RTOSINIT_H
+
+#include "RTOS.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+*  These defines can be set as project option or in OS_Config.h.
+*
+**********************************************************************
+*/
+
+//
+// Tickless idle. When enabled, OS_Idle() programs MTIMECMP to the
+// next embOS timeout instead of handling every system tick.
+//
+#ifndef   TICKLESS_IDLE
+  #define TICKLESS_IDLE            (0)
+#endif
+
+#ifndef   TICKLESS_MAX_IDLE_TICKS
+  #define TICKLESS_MAX_IDLE_TICKS  (0x7FFFFFFF)  // Upper limit for a single tickless period
+#endif
+
+//
+// Bulk catch-up of missed ticks. When enabled, ISR_M_Timer() accounts
+// for ticks missed while interrupts were disabled in a single step
+// instead of calling OS_TICK_Handle() once per missed tick.
+//
+#ifndef   TICK_CATCHUP_BULK
+  #define TICK_CATCHUP_BULK        (0)
+#endif
+
+//
+// High-resolution deadline service (BSP_Deadline.c), multiplexed with
+// the system tick on the machine timer compare register.
+//
+#ifndef   DEADLINE_SERVICE
+  #define DEADLINE_SERVICE         (0)
+#endif
+
+//
+// Hierarchical timing wheel (BSP_TimerWheel.c), advanced by a tick hook.
+//
+#ifndef   TIMER_WHEEL
+  #define TIMER_WHEEL              (0)
+#endif
+
+//
+// Software timers with per-timer slack (BSP_SlackTimer.c), coalesced
+// into a single embOS software timer.
+//
+#ifndef   SLACK_TIMER
+  #define SLACK_TIMER              (0)
+#endif
+
+//
+// Deferred interrupt work (BSP_DeferredWork.c), executed by a worker task.
+//
+#ifndef   DEFERRED_WORK
+  #define DEFERRED_WORK            (0)
+#endif
+
+//
+// Deferred logging (BSP_Log.c). When enabled, _write() queues its data
+// to a lock-free ring, which is flushed to a UART by a task or OS_Idle().
+//
+#ifndef   DEFERRED_LOG
+  #define DEFERRED_LOG             (0)
+#endif
+
+//
+// Tick interrupt statistics. When enabled, ISR_M_Timer() records its
+// entry lateness and the duration of the tick handling.
+//
+#ifndef   TICK_STATISTICS
+  #define TICK_STATISTICS          (0)
+#endif
+
+//
+// Vectored CLINT trap mode. When enabled, machine software, timer and
+// external interrupts enter ISR_M_Software/Timer/External() directly
+// via vtrap_entry.S instead of OS_TrapHandler().
+//
+#ifndef   CLINT_VECTORED_MODE
+  #define CLINT_VECTORED_MODE      (0)
+#endif
+
+//
+// Allows to pass a context to global ISRs, see BSP_PLIC_InstallISR_Ex().
+//
+#ifndef   EXTEND_GLOBAL_ISR_CONTEXT
+  #define EXTEND_GLOBAL_ISR_CONTEXT  (1)
+#endif
+
+//
+// Upper limit of global IRQs served by a single ISR_M_External() entry.
+// 1 serves one IRQ per entry.
+//
+#ifndef   PLIC_MAX_CLAIMS_PER_ENTRY
+  #define PLIC_MAX_CLAIMS_PER_ENTRY  (8u)
+#endif
+
+//
+// Drain statistics. When enabled, ISR_M_External() records the number
+// of global IRQs served per entry, see BSP_PLIC_GetDrainStat().
+//
+#ifndef   PLIC_DRAIN_STATISTICS
+  #define PLIC_DRAIN_STATISTICS    (0)
+#endif
+
+//
+// Nestable dispatch of global IRQs. When enabled, ISR_M_External() raises
+// the PLIC threshold to the priority of the claimed IRQ and re-enables
+// interrupts while its handler runs, so that IRQs of higher priority
+// preempt it.
+//
+#ifndef   PLIC_NESTABLE
+  #define PLIC_NESTABLE            (0)
+#endif
+
+//
+// Interrupt storm detection (BSP_IRQStorm.c). When enabled,
+// ISR_M_External() counts each embOS-tier IRQ, and IRQs exceeding a
+// rate limit are masked and polled by a task.
+//
+#ifndef   IRQ_STORM_DETECTION
+  #define IRQ_STORM_DETECTION      (0)
+#endif
+
+//
+// Interrupt stack. When enabled, ISR_M_Software/Timer/External() run
+// their handlers on the system stack instead of the task stack, hence
+// task stacks need not reserve space for interrupt handlers.
+//
+#ifndef   INT_STACK
+  #define INT_STACK                (0)
+#endif
+
+//
+// Per-IRQ interrupt statistics. When enabled, OS_TrapHandler() and
+// ISR_M_External() record latency and duration of each interrupt
+// source in CPU cycles.
+//
+#ifndef   IRQ_STATISTICS
+  #define IRQ_STATISTICS           (0)
+#endif
+
+#ifndef   IRQ_STAT_NUM_BUCKETS
+  #define IRQ_STAT_NUM_BUCKETS     (16u)  // Log2 buckets, the last one counts all samples >= 2^(n-2)
+#endif
+
+//
+// Per-IRQ occurrence counters. When enabled, OS_TrapHandler() and
+// ISR_M_External() count the calls of each interrupt source, as well
+// as spurious claims and calls of non-installed handlers. A source
+// without a handler is then masked instead of halting in a loop.
+//
+#ifndef   IRQ_COUNTERS
+  #define IRQ_COUNTERS             (0)
+#endif
+
+//
+// Zero-latency interrupt tier. Global IRQs marked via
+// BSP_PLIC_SetZeroLatency() are served without OS_INT_Enter() and are
+// not masked by BSP_INT_DisableEmbOS(). All other global IRQs must use
+// a priority of at most BSP_PLIC_EMBOS_MAX_PRIORITY.
+//
+#ifndef   ZERO_LATENCY_TIER
+  #define ZERO_LATENCY_TIER        (0)
+#endif
+
+#ifndef   BSP_PLIC_ZL_PRIORITY
+  #define BSP_PLIC_ZL_PRIORITY     (PLIC_MAX_PRIORITY)  // PLIC priority of zero-latency IRQs
+#endif
+
+//
+// Constant interrupt handler tables. When enabled, the handlers of the
+// core-local and global interrupts are taken from const tables built
+// at compile time instead of the RAM tables clint_isr[] and plic_isr[].
+// Handlers are added as designated initializers, e.g.
+//   #define BSP_PLIC_ISR_TABLE  [GPIO0_IRQn] = GPIO0_isr, [TIMER0_IRQn] = TIMER0_isr,
+// All other entries call _ISR_NotInstalled(). OS_CLINT_InstallISR() and
+// OS_PLIC_InstallISR() must not be used, BSP_PLIC_InstallISR_Ex() may be.
+//
+#ifndef   ISR_TABLE_CONST
+  #define ISR_TABLE_CONST          (0)
+#endif
+
+#ifndef   BSP_CLINT_ISR_TABLE
+  #define BSP_CLINT_ISR_TABLE      // Additional core-local handlers, [Cause] = Handler,
+#endif
+
+#ifndef   BSP_PLIC_ISR_TABLE
+  #define BSP_PLIC_ISR_TABLE       // Additional global handlers, [IRQIndex] = Handler,
+#endif
+
+#if ((TICKLESS_IDLE != 0) || (TICK_CATCHUP_BULK != 0)) && (OS_SUPPORT_TICKLESS == 0)
+  #error "TICKLESS_IDLE and TICK_CATCHUP_BULK require OS_SUPPORT_TICKLESS"
+#endif
+
+#if (PLIC_MAX_CLAIMS_PER_ENTRY < 1)
+  #error "PLIC_MAX_CLAIMS_PER_ENTRY must be at least 1"
+#endif
+
+/*********************************************************************
+*
+*       Defines, fixed
+*
+**********************************************************************
+*/
+#define BSP_MTIMER_NO_DEADLINE     (0xFFFFFFFFFFFFFFFFuLL)
+#define BSP_TICK_STAT_NUM_BUCKETS  (32u)
+
+#if (ZERO_LATENCY_TIER != 0)
+  #define BSP_PLIC_EMBOS_MAX_PRIORITY  (BSP_PLIC_ZL_PRIORITY - 1u)  // Highest PLIC priority of IRQs which call embOS API
+#else
+  #define BSP_PLIC_EMBOS_MAX_PRIORITY  (PLIC_MAX_PRIORITY)
+#endif
+
+/*********************************************************************
+*
+*       Types, global
+*
+**********************************************************************
+*/
+
+typedef struct {
+  OS_U32 NumSamples;
+  OS_U32 Min;
+  OS_U32 Max;
+  OS_U32 Mean;                                // Set by BSP_TICK_GetStat()
+  OS_U64 Sum;
+  OS_U32 aBucket[BSP_TICK_STAT_NUM_BUCKETS];  // [0]: value 0, [n]: values in [2^(n-1), 2^n)
+} BSP_TICK_HISTOGRAM;
+
+typedef struct {
+  BSP_TICK_HISTOGRAM Latency;   // Interrupt entry after programmed compare value, in timer cycles
+  BSP_TICK_HISTOGRAM Duration;  // Tick handling per interrupt, in CPU cycles
+} BSP_TICK_STAT;
+
+typedef struct {
+  OS_U32 NumEntries;                                        // Number of ISR_M_External() entries
+  OS_U32 NumServed;                                         // Number of global IRQs served
+  OS_U32 aServedPerEntry[PLIC_MAX_CLAIMS_PER_ENTRY + 1u];  // [n]: entries which served n IRQs
+} BSP_PLIC_DRAIN_STAT;
+
+typedef struct {
+  OS_U32 MaxDepth;        // Maximum number of nested global IRQ handlers
+  OS_U32 NumNested;       // Handlers which preempted another handler
+  OS_U32 NumOrderErrors;  // Nested handlers whose priority did not exceed the preempted one
+} BSP_PLIC_NEST_STAT;
+
+typedef struct {
+  OS_U32 InitHWStart;     // CPU cycles from reset to the entry of OS_InitHW()
+  OS_U32 InitHWDuration;  // CPU cycles spent in OS_InitHW()
+} BSP_BOOT_STAT;
+
+typedef struct {
+  OS_U32 NumCalls;
+  OS_U32 LatencyMin;                       // OS_TrapHandler() entry to handler start, in CPU cycles
+  OS_U32 LatencyMax;
+  OS_U32 DurationMin;                      // Handler start to handler return, in CPU cycles
+  OS_U32 DurationMax;
+  OS_U32 aLatency[IRQ_STAT_NUM_BUCKETS];   // [0]: value 0, [n]: values in [2^(n-1), 2^n)
+  OS_U32 aDuration[IRQ_STAT_NUM_BUCKETS];
+} BSP_IRQ_STAT;
+
+typedef struct {
+  OS_U32 NumCalls;  // Calls since the last reset
+  OS_U32 Rate;      // Calls per second since the last reset
+} BSP_IRQ_COUNT;
+
+typedef struct {
+  OS_U64 Time_us;          // OS_TIME_Get_us64() when the snapshot was taken
+  OS_U64 Period_us;        // Time since the last reset
+  OS_U32 NumSpurious;      // ISR_M_External() entries whose first claim returned 0
+  OS_U32 NumNotInstalled;  // Calls of interrupt sources without a handler, which were masked then
+} BSP_IRQ_COUNT_INFO;
+
+/*********************************************************************
+*
+*       API functions / Function prototypes
+*
+**********************************************************************
+*/
+#if defined(__cplusplus)
+  extern "C" {
+#endif
+
+int    BSP_TICK_SetFreq(OS_U32 TickFreq, OS_U32 IntFreq);
+void   BSP_BOOT_GetStat(BSP_BOOT_STAT* pStat);
+
+#if (TICKLESS_IDLE != 0)
+OS_U32 BSP_TICK_GetNumSkipped(void);
+#else
+  #define BSP_TICK_GetNumSkipped()  (0u)
+#endif
+
+#if (DEADLINE_SERVICE != 0)
+void   BSP_MTIMER_SetDeadline(OS_U64 Compare);
+#endif
+
+#if (TICK_CATCHUP_BULK != 0)
+OS_U32 BSP_TICK_GetNumCoalesced(void);
+#else
+  #define BSP_TICK_GetNumCoalesced()  (0u)
+#endif
+
+#if (EXTEND_GLOBAL_ISR_CONTEXT != 0)
+OS_IRQ_HANDLER_EX* BSP_PLIC_InstallISR_Ex(OS_U32 IRQIndex, OS_IRQ_HANDLER_EX* pfISR, void* pContext);
+#endif
+
+#if (IRQ_STORM_DETECTION != 0)
+int    BSP_PLIC_PollISR        (OS_U32 IRQIndex);
+#endif
+
+#if (INT_STACK != 0)
+OS_U32 BSP_INTSTACK_GetSize    (void);
+OS_U32 BSP_INTSTACK_GetUsed    (void);
+#endif
+
+#if (PLIC_DRAIN_STATISTICS != 0)
+void   BSP_PLIC_GetDrainStat   (BSP_PLIC_DRAIN_STAT* pStat);
+void   BSP_PLIC_ResetDrainStat (void);
+#endif
+
+#if (PLIC_NESTABLE != 0)
+void   BSP_PLIC_GetNestStat    (BSP_PLIC_NEST_STAT* pStat);
+void   BSP_PLIC_ResetNestStat  (void);
+#endif
+
+#if (IRQ_STATISTICS != 0)
+int    BSP_IRQ_GetCLINTStat    (OS_U32 IRQIndex, BSP_IRQ_STAT* pStat);
+int    BSP_IRQ_GetPLICStat     (OS_U32 IRQIndex, BSP_IRQ_STAT* pStat);
+void   BSP_IRQ_ResetStat       (void);
+#endif
+
+#if (IRQ_COUNTERS != 0)
+void   BSP_IRQ_GetCounts       (BSP_IRQ_COUNT_INFO* pInfo, BSP_IRQ_COUNT* paCLINT, OS_U32 NumCLINT, BSP_IRQ_COUNT* paPLIC, OS_U32 NumPLIC);
+void   BSP_IRQ_ResetCounts     (void);
+#endif
+
+#if (ZERO_LATENCY_TIER != 0)
+int    BSP_PLIC_SetZeroLatency (OS_U32 IRQIndex, OS_BOOL OnOff);
+void   BSP_INT_DisableEmbOS    (void);
+void   BSP_INT_EnableEmbOS     (void);
+#else
+  #define BSP_INT_DisableEmbOS()  OS_INT_IncDI()
+  #define BSP_INT_EnableEmbOS()   OS_INT_DecRI()
+#endif
+
+#if (TICK_STATISTICS != 0)
+void   BSP_TICK_GetStat        (BSP_TICK_STAT* pStat);
+void   BSP_TICK_ResetStat      (void);
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif  // RTOSINIT_H
+
+/*************************** End of file ****************************/
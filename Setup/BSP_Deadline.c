@@ -0,0 +1,302 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 1995 - 2022 SEGGER Microcontroller GmbH                  *
+*                                                                    *
+*       Internet: segger.com  Support: support_embos@segger.com      *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       embOS * Real time operating system                           *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product or a real-time            *
+*       operating system for in-house use.                           *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       OS version: V5.18.0.0                                        *
+*                                                                    *
+**********************************************************************
+
+-------------------------- END-OF-HEADER -----------------------------
+File    : BSP_Deadline.c
+Purpose : High-resolution one-shot deadlines on the machine timer.
+
+Additional information:
+  Active deadlines are kept in a list sorted by expiration time. The
+  earliest one is passed to RTOSInit via BSP_MTIMER_SetDeadline(),
+  which programs MTIMECMP with the earlier of this deadline and the
+  next system tick. Expired deadlines are handled by ISR_M_Timer(),
+  hence their callbacks run in interrupt context at the exact timer
+  cycle instead of the next tick boundary.
+*/
+
+#include "BSP_Deadline.h"
+#include "BSP_Timestamp.h"
+
+#if (DEADLINE_SERVICE != 0)
+
+/*********************************************************************
+*
+*       Defines
+*
+**********************************************************************
+*/
+#define MTIMER_FREQ  (BSP_TS_MTIME_FREQ)
+#define MTIME        (BSP_TS_GetMTime())  // Tear-free read of the timer counter register
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static BSP_DEADLINE* _pFirst;  // Active deadlines, sorted by expiration time
+
+/*********************************************************************
+*
+*       Local functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       _Unlink()
+*
+*  Function description
+*    Removes a deadline from the list of active deadlines.
+*
+*  Return value
+*    == 0: Deadline was not the first one.
+*    != 0: Deadline was the first one, MTIMECMP must be updated.
+*/
+static int _Unlink(BSP_DEADLINE* pDeadline) {
+  BSP_DEADLINE** ppLink;
+
+  ppLink = &_pFirst;
+  while (*ppLink != NULL) {
+    if (*ppLink == pDeadline) {
+      *ppLink           = pDeadline->pNext;
+      pDeadline->Active = 0u;
+      return (ppLink == &_pFirst) ? 1 : 0;
+    }
+    ppLink = &(*ppLink)->pNext;
+  }
+  return 0;
+}
+
+/*********************************************************************
+*
+*       _UpdateCompare()
+*
+*  Function description
+*    Passes the earliest pending deadline to RTOSInit.
+*/
+static void _UpdateCompare(void) {
+  BSP_MTIMER_SetDeadline((_pFirst != NULL) ? _pFirst->Expire : BSP_MTIMER_NO_DEADLINE);
+}
+
+/*********************************************************************
+*
+*       _WakeTask()
+*
+*  Function description
+*    Deadline routine used by BSP_DEADLINE_DelayUntil().
+*/
+static void _WakeTask(void* pContext) {
+  OS_TASKEVENT_Set((OS_TASK*)pContext, BSP_DEADLINE_TASKEVENT);
+}
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       BSP_DEADLINE_GetTime()
+*
+*  Function description
+*    Returns the current machine timer value, which is the time base
+*    of all deadlines.
+*/
+OS_U64 BSP_DEADLINE_GetTime(void) {
+  return MTIME;
+}
+
+/*********************************************************************
+*
+*       BSP_DEADLINE_Convertus2Cycles()
+*
+*  Function description
+*    Converts microseconds into machine timer cycles.
+*/
+OS_U64 BSP_DEADLINE_Convertus2Cycles(OS_U32 us) {
+  return ((OS_U64)us * MTIMER_FREQ) / 1000000u;
+}
+
+/*********************************************************************
+*
+*       BSP_DEADLINE_Start()
+*
+*  Function description
+*    Starts a one-shot deadline at an absolute machine timer value.
+*
+*  Parameters
+*    pDeadline: Pointer to a deadline object.
+*    Expire:    Absolute machine timer value, see BSP_DEADLINE_GetTime().
+*    pfRoutine: Routine which is called from the timer interrupt when
+*               the deadline expires.
+*    pContext:  Parameter passed to pfRoutine.
+*
+*  Additional information
+*    May be called from tasks, interrupts and deadline routines. An
+*    already active deadline is restarted. A deadline which already
+*    passed expires immediately.
+*/
+void BSP_DEADLINE_Start(BSP_DEADLINE* pDeadline, OS_U64 Expire, BSP_DEADLINE_ROUTINE* pfRoutine, void* pContext) {
+  BSP_DEADLINE** ppLink;
+
+  OS_INT_IncDI();
+  if (pDeadline->Active != 0u) {
+    (void)_Unlink(pDeadline);
+  }
+  pDeadline->Expire    = Expire;
+  pDeadline->pfRoutine = pfRoutine;
+  pDeadline->pContext  = pContext;
+  pDeadline->Active    = 1u;
+  ppLink = &_pFirst;
+  while ((*ppLink != NULL) && ((*ppLink)->Expire <= Expire)) {  // Deadlines with equal expiration time expire in the order they were started
+    ppLink = &(*ppLink)->pNext;
+  }
+  pDeadline->pNext = *ppLink;
+  *ppLink          = pDeadline;
+  //
+  // MTIMECMP needs to be updated only if the new deadline is the earliest one.
+  //
+  if (ppLink == &_pFirst) {
+    _UpdateCompare();
+  }
+  OS_INT_DecRI();
+}
+
+/*********************************************************************
+*
+*       BSP_DEADLINE_Start_us()
+*
+*  Function description
+*    Starts a one-shot deadline relative to the current time.
+*
+*  Parameters
+*    pDeadline: Pointer to a deadline object.
+*    us:        Microseconds from now.
+*    pfRoutine: Routine which is called from the timer interrupt when
+*               the deadline expires.
+*    pContext:  Parameter passed to pfRoutine.
+*/
+void BSP_DEADLINE_Start_us(BSP_DEADLINE* pDeadline, OS_U32 us, BSP_DEADLINE_ROUTINE* pfRoutine, void* pContext) {
+  BSP_DEADLINE_Start(pDeadline, MTIME + BSP_DEADLINE_Convertus2Cycles(us), pfRoutine, pContext);
+}
+
+/*********************************************************************
+*
+*       BSP_DEADLINE_Stop()
+*
+*  Function description
+*    Stops a deadline. The deadline routine is not called afterwards.
+*/
+void BSP_DEADLINE_Stop(BSP_DEADLINE* pDeadline) {
+  OS_INT_IncDI();
+  if (pDeadline->Active != 0u) {
+    if (_Unlink(pDeadline) != 0) {
+      _UpdateCompare();
+    }
+  }
+  OS_INT_DecRI();
+}
+
+/*********************************************************************
+*
+*       BSP_DEADLINE_IsActive()
+*
+*  Return value
+*    == 0: Deadline expired or was stopped.
+*    != 0: Deadline is pending.
+*/
+OS_BOOL BSP_DEADLINE_IsActive(const BSP_DEADLINE* pDeadline) {
+  return pDeadline->Active;
+}
+
+/*********************************************************************
+*
+*       BSP_DEADLINE_DelayUntil()
+*
+*  Function description
+*    Suspends the calling task until the machine timer reaches Expire.
+*
+*  Additional information
+*    Uses the task event BSP_DEADLINE_TASKEVENT, which must not be used
+*    otherwise by the calling task.
+*/
+void BSP_DEADLINE_DelayUntil(OS_U64 Expire) {
+  BSP_DEADLINE Deadline;
+
+  Deadline.Active = 0u;
+  BSP_DEADLINE_Start(&Deadline, Expire, _WakeTask, OS_TASK_GetID());
+  (void)OS_TASKEVENT_GetBlocked(BSP_DEADLINE_TASKEVENT);
+}
+
+/*********************************************************************
+*
+*       BSP_DEADLINE_Delay_us()
+*
+*  Function description
+*    Suspends the calling task for the given number of microseconds
+*    with machine timer resolution.
+*
+*  Additional information
+*    Uses the task event BSP_DEADLINE_TASKEVENT, which must not be used
+*    otherwise by the calling task.
+*/
+void BSP_DEADLINE_Delay_us(OS_U32 us) {
+  BSP_DEADLINE_DelayUntil(MTIME + BSP_DEADLINE_Convertus2Cycles(us));
+}
+
+/*********************************************************************
+*
+*       BSP_DEADLINE_Handle()
+*
+*  Function description
+*    Calls the routines of all expired deadlines.
+*
+*  Additional information
+*    Called by ISR_M_Timer() with interrupts disabled. The current time
+*    is read again after each routine, so that deadlines which expire
+*    meanwhile are handled within the same interrupt.
+*/
+void BSP_DEADLINE_Handle(void) {
+  BSP_DEADLINE* pDeadline;
+
+  pDeadline = _pFirst;
+  while ((pDeadline != NULL) && (pDeadline->Expire <= MTIME)) {
+    _pFirst           = pDeadline->pNext;
+    pDeadline->Active = 0u;
+    pDeadline->pfRoutine(pDeadline->pContext);
+    pDeadline = _pFirst;
+  }
+  _UpdateCompare();
+}
+
+#endif  // DEADLINE_SERVICE
+
+/*************************** End of file ****************************/
@@ -0,0 +1,292 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 1995 - 2022 SEGGER Microcontroller GmbH                  *
+*                                                                    *
+*       Internet: segger.com  Support: support_embos@segger.com      *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       embOS * Real time operating system                           *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product or a real-time            *
+*       operating system for in-house use.                           *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       OS version: V5.18.0.0                                        *
+*                                                                    *
+**********************************************************************
+
+-------------------------- END-OF-HEADER -----------------------------
+File    : BSP_DeferredWork.c
+Purpose : Deferred interrupt work, executed by a worker task.
+
+Additional information:
+  ISRs post work items, a routine and its context, to a bounded ring.
+  The ring is lock-free: each slot carries a sequence number, a
+  producer reserves a slot by advancing the write position with a
+  compare-and-swap and publishes it by updating the sequence number.
+  Nested ISRs may therefore post concurrently without disabling
+  interrupts. The worker task is the single consumer.
+
+  The worker task is signaled only by the post which finds the ring
+  empty. Further posts while the worker task is running or about to
+  run cost no embOS call at all, which is cheaper than a semaphore
+  per event.
+*/
+
+#include "BSP_DeferredWork.h"
+#include "BSP_Timestamp.h"
+
+#if (DEFERRED_WORK != 0)
+
+/*********************************************************************
+*
+*       Defines
+*
+**********************************************************************
+*/
+#define ITEM_MASK  (BSP_DEFER_NUM_ITEMS - 1u)
+
+/*********************************************************************
+*
+*       Types, local
+*
+**********************************************************************
+*/
+typedef struct {
+  OS_U32             Seq;        // == Position: free, == Position + 1: published
+  BSP_DEFER_ROUTINE* pfRoutine;
+  void*              pContext;
+  OS_U32             TimeStamp;  // CPU cycles at post
+} ITEM;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static ITEM           _aItem[BSP_DEFER_NUM_ITEMS];
+static OS_U32         _WrPos;  // Next position to be reserved by a producer
+static OS_U32         _RdPos;  // Next position to be executed, written by the worker task only
+static BSP_DEFER_STAT _Stat;
+static OS_TASK        _Task;
+static OS_STACKPTR OS_U32 _aStack[BSP_DEFER_STACK_SIZE];
+
+/*********************************************************************
+*
+*       Local functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       _UpdateMax()
+*
+*  Function description
+*    Raises *pMax to Value, safe against concurrent producers.
+*/
+static void _UpdateMax(OS_U32* pMax, OS_U32 Value) {
+  OS_U32 Max;
+
+  Max = __atomic_load_n(pMax, __ATOMIC_RELAXED);
+  while (Value > Max) {
+    if (__atomic_compare_exchange_n(pMax, &Max, Value, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+      break;
+    }
+  }
+}
+
+/*********************************************************************
+*
+*       _Execute()
+*
+*  Function description
+*    Executes the next published work item.
+*
+*  Return value
+*    == 0: Ring is empty.
+*    != 0: One work item was executed.
+*/
+static int _Execute(void) {
+  ITEM*              pItem;
+  BSP_DEFER_ROUTINE* pfRoutine;
+  void*              pContext;
+  OS_U32             Latency;
+
+  pItem = &_aItem[_RdPos & ITEM_MASK];
+  if (__atomic_load_n(&pItem->Seq, __ATOMIC_ACQUIRE) != (_RdPos + 1u)) {
+    return 0;
+  }
+  pfRoutine = pItem->pfRoutine;
+  pContext  = pItem->pContext;
+  Latency   = BSP_TS_GetCycles() - pItem->TimeStamp;
+  __atomic_store_n(&pItem->Seq, _RdPos + BSP_DEFER_NUM_ITEMS, __ATOMIC_RELEASE);  // Release the slot for the next round
+  __atomic_store_n(&_RdPos, _RdPos + 1u, __ATOMIC_RELEASE);
+  OS_INT_IncDI();
+  _Stat.NumExecuted++;
+  _Stat.LatencySum += Latency;
+  if (Latency > _Stat.LatencyMax) {
+    _Stat.LatencyMax = Latency;
+  }
+  OS_INT_DecRI();
+  pfRoutine(pContext);
+  return 1;
+}
+
+/*********************************************************************
+*
+*       _Worker()
+*
+*  Function description
+*    Worker task, executes work items in batches of
+*    BSP_DEFER_BATCH_SIZE.
+*/
+static void _Worker(void) {
+  OS_U32 NumExecuted;
+
+  while (1) {
+    NumExecuted = 0u;
+    while (_Execute() != 0) {
+      NumExecuted++;
+      if (NumExecuted == BSP_DEFER_BATCH_SIZE) {
+        NumExecuted = 0u;
+        OS_TASK_Yield();
+      }
+    }
+    (void)OS_TASKEVENT_GetBlocked(BSP_DEFER_TASKEVENT);
+  }
+}
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       BSP_DEFER_Init()
+*
+*  Function description
+*    Initializes the work queue and creates the worker task.
+*
+*  Parameters
+*    Priority: embOS priority of the worker task.
+*/
+void BSP_DEFER_Init(OS_PRIO Priority) {
+  OS_U32 i;
+
+  for (i = 0u; i < BSP_DEFER_NUM_ITEMS; i++) {
+    _aItem[i].Seq = i;
+  }
+  _WrPos = 0u;
+  _RdPos = 0u;
+  BSP_DEFER_ResetStat();
+  OS_TASK_Create(&_Task, "Deferred work", Priority, _Worker, _aStack, sizeof(_aStack), 2u);
+}
+
+/*********************************************************************
+*
+*       BSP_DEFER_Post()
+*
+*  Function description
+*    Queues a routine for execution by the worker task.
+*
+*  Parameters
+*    pfRoutine: Routine which is called from the worker task.
+*    pContext:  Parameter passed to pfRoutine.
+*
+*  Return value
+*    == 0: O.K.
+*    != 0: Error, the queue is full.
+*
+*  Additional information
+*    May be called from embOS ISRs, including nested ones, and from
+*    tasks. Must not be called from zero-latency ISRs, as it may call
+*    OS_TASKEVENT_Set(). Work items are executed in the order their
+*    slots were reserved.
+*/
+int BSP_DEFER_Post(BSP_DEFER_ROUTINE* pfRoutine, void* pContext) {
+  ITEM*  pItem;
+  OS_U32 Pos;
+  OS_I32 Diff;
+
+  Pos = __atomic_load_n(&_WrPos, __ATOMIC_RELAXED);
+  while (1) {
+    pItem = &_aItem[Pos & ITEM_MASK];
+    Diff  = (OS_I32)(__atomic_load_n(&pItem->Seq, __ATOMIC_ACQUIRE) - Pos);
+    if (Diff == 0) {
+      if (__atomic_compare_exchange_n(&_WrPos, &Pos, Pos + 1u, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        break;                                          // Slot reserved
+      }                                                 // Else Pos was updated by the failed exchange
+    } else if (Diff < 0) {
+      __atomic_fetch_add(&_Stat.NumOverflows, 1u, __ATOMIC_RELAXED);
+      return -1;                                        // Slot still holds an item of the previous round
+    } else {
+      Pos = __atomic_load_n(&_WrPos, __ATOMIC_RELAXED);  // Slot was reserved by a preempting producer
+    }
+  }
+  pItem->pfRoutine = pfRoutine;
+  pItem->pContext  = pContext;
+  pItem->TimeStamp = BSP_TS_GetCycles();
+  __atomic_store_n(&pItem->Seq, Pos + 1u, __ATOMIC_RELEASE);  // Publish
+  __atomic_fetch_add(&_Stat.NumPosted, 1u, __ATOMIC_RELAXED);
+  _UpdateMax(&_Stat.MaxDepth, Pos + 1u - __atomic_load_n(&_RdPos, __ATOMIC_ACQUIRE));
+  //
+  // Only the item posted to an empty ring needs to wake the worker task.
+  // It cannot run before all posting ISRs returned and then executes all
+  // items published until the ring is empty again.
+  //
+  if (Pos == __atomic_load_n(&_RdPos, __ATOMIC_ACQUIRE)) {
+    OS_TASKEVENT_Set(&_Task, BSP_DEFER_TASKEVENT);
+  }
+  return 0;
+}
+
+/*********************************************************************
+*
+*       BSP_DEFER_GetStat()
+*
+*  Function description
+*    Returns a consistent copy of the work queue statistics.
+*/
+void BSP_DEFER_GetStat(BSP_DEFER_STAT* pStat) {
+  OS_INT_IncDI();
+  *pStat = _Stat;
+  OS_INT_DecRI();
+  if (pStat->NumExecuted != 0u) {
+    pStat->LatencyMean = (OS_U32)(pStat->LatencySum / pStat->NumExecuted);
+  }
+}
+
+/*********************************************************************
+*
+*       BSP_DEFER_ResetStat()
+*/
+void BSP_DEFER_ResetStat(void) {
+  OS_INT_IncDI();
+  _Stat.NumPosted    = 0u;
+  _Stat.NumExecuted  = 0u;
+  _Stat.NumOverflows = 0u;
+  _Stat.MaxDepth     = 0u;
+  _Stat.LatencyMax   = 0u;
+  _Stat.LatencyMean  = 0u;
+  _Stat.LatencySum   = 0u;
+  OS_INT_DecRI();
+}
+
+#endif  // DEFERRED_WORK
+
+/*************************** End of file ****************************/
@@ -0,0 +1,269 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 1995 - 2022 SEGGER Microcontroller GmbH                  *
+*                                                                    *
+*       Internet: segger.com  Support: support_embos@segger.com      *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       embOS * Real time operating system                           *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product or a real-time            *
+*       operating system for in-house use.                           *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       OS version: V5.18.0.0                                        *
+*                                                                    *
+**********************************************************************
+
+-------------------------- END-OF-HEADER -----------------------------
+File    : BSP_IRQStorm.c
+Purpose : Detection and rate limiting of global interrupt storms.
+
+Additional information:
+  ISR_M_External() counts each served embOS-tier IRQ via
+  BSP_STORM_Count(). An IRQ which exceeds BSP_STORM_MAX_IRQS within
+  BSP_STORM_WINDOW_US is masked with OS_PLIC_DisableInt(), so that a
+  stuck or noisy line cannot starve the tasks.
+
+  While masked, the poll task calls the handler of the IRQ every
+  BSP_STORM_POLL_PERIOD ticks, so that the peripheral is still served.
+  Handlers of such IRQs must therefore tolerate being called without a
+  pending event. After the backoff period the IRQ is unmasked again.
+  If it storms again within its previous backoff period, the backoff
+  period is doubled, else it restarts at BSP_STORM_MIN_BACKOFF.
+
+  Masking and unmasking are logged, see BSP_STORM_GetLog().
+*/
+
+#include "BSP_IRQStorm.h"
+#include "BSP_Timestamp.h"
+#include "board.h"
+
+#if (IRQ_STORM_DETECTION != 0)
+
+/*********************************************************************
+*
+*       Defines
+*
+**********************************************************************
+*/
+#define NUM_IRQS       (PLIC_TOTAL_INTERRUPT_COUNT)
+#define WINDOW_CYCLES  ((OS_U32)(((OS_U64)BSP_STORM_WINDOW_US * BSP_TS_CYCLE_FREQ) / 1000000u))
+
+/*********************************************************************
+*
+*       Types, local
+*
+**********************************************************************
+*/
+typedef struct {
+  OS_U32  WindowStart;  // CPU cycles at the start of the current window
+  OS_U32  NumIRQs;      // IRQs within the current window
+  OS_TIME Backoff;      // Current backoff period, 0 if the IRQ never stormed
+  OS_TIME Time;         // Masked: time to unmask. Unmasked: time it was unmasked.
+  OS_BOOL IsMasked;
+} SOURCE;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static SOURCE              _aSource[NUM_IRQS];
+static BSP_STORM_LOG_ENTRY _aLog[BSP_STORM_LOG_SIZE];
+static OS_U32              _NumLogged;    // Total number of logged events, the log keeps the latest ones
+static OS_U32              _NumMasked;    // Number of currently masked IRQs
+static OS_TASK             _Task;
+static OS_STACKPTR OS_U32  _aStack[BSP_STORM_STACK_SIZE];
+
+/*********************************************************************
+*
+*       Local functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       _Log()
+*
+*  Additional information
+*    Must be called with interrupts disabled.
+*/
+static void _Log(OS_U32 IRQIndex, OS_U8 Event, OS_U32 NumIRQs, OS_TIME Backoff) {
+  BSP_STORM_LOG_ENTRY* pEntry;
+
+  pEntry           = &_aLog[_NumLogged % BSP_STORM_LOG_SIZE];
+  pEntry->Time     = OS_TIME_GetTicks();
+  pEntry->IRQIndex = (OS_U16)IRQIndex;
+  pEntry->Event    = Event;
+  pEntry->NumIRQs  = NumIRQs;
+  pEntry->Backoff  = Backoff;
+  _NumLogged++;
+}
+
+/*********************************************************************
+*
+*       _Poll()
+*
+*  Function description
+*    Poll task. Serves masked IRQs and unmasks them after their backoff
+*    period.
+*/
+static void _Poll(void) {
+  SOURCE* pSource;
+  OS_U32  i;
+
+  while (1) {
+    if (_NumMasked == 0u) {
+      (void)OS_TASKEVENT_GetBlocked(BSP_STORM_TASKEVENT);
+    } else {
+      OS_TASK_Delay(BSP_STORM_POLL_PERIOD);
+    }
+    for (i = 1u; i < NUM_IRQS; i++) {
+      pSource = &_aSource[i];
+      if (pSource->IsMasked != 0u) {
+        (void)BSP_PLIC_PollISR(i);
+        OS_INT_IncDI();
+        if ((OS_TIME)(OS_TIME_GetTicks() - pSource->Time) >= 0) {
+          pSource->IsMasked    = 0u;
+          pSource->NumIRQs     = 0u;
+          pSource->WindowStart = BSP_TS_GetCycles();
+          pSource->Time        = OS_TIME_GetTicks();
+          _NumMasked--;
+          _Log(i, BSP_STORM_EVENT_UNMASKED, 0u, pSource->Backoff);
+          OS_PLIC_EnableInt(i);
+        }
+        OS_INT_DecRI();
+      }
+    }
+  }
+}
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       BSP_STORM_Init()
+*
+*  Function description
+*    Creates the poll task.
+*
+*  Parameters
+*    Priority: embOS priority of the poll task.
+*/
+void BSP_STORM_Init(OS_PRIO Priority) {
+  OS_TASK_Create(&_Task, "IRQ storm", Priority, _Poll, _aStack, sizeof(_aStack), 2u);
+}
+
+/*********************************************************************
+*
+*       BSP_STORM_Count()
+*
+*  Function description
+*    Counts an IRQ and masks it if its rate exceeds the limit.
+*
+*  Additional information
+*    Called by ISR_M_External() after the handler of an embOS-tier IRQ
+*    returned, before the IRQ is completed.
+*/
+void BSP_STORM_Count(OS_U32 IRQIndex) {
+  SOURCE* pSource;
+  OS_U32  Now;
+  OS_TIME Time;
+
+  pSource = &_aSource[IRQIndex];
+  Now     = BSP_TS_GetCycles();
+  if ((Now - pSource->WindowStart) >= WINDOW_CYCLES) {
+    pSource->WindowStart = Now;
+    pSource->NumIRQs     = 0u;
+  }
+  pSource->NumIRQs++;
+  if (pSource->NumIRQs > BSP_STORM_MAX_IRQS) {
+    OS_INT_IncDI();
+    OS_PLIC_DisableInt(IRQIndex);
+    Time = OS_TIME_GetTicks();
+    if ((pSource->Backoff != 0) && ((OS_TIME)(Time - pSource->Time) < pSource->Backoff)) {
+      pSource->Backoff *= 2;                           // Storm recurred right after unmasking
+      if (pSource->Backoff > BSP_STORM_MAX_BACKOFF) {
+        pSource->Backoff = BSP_STORM_MAX_BACKOFF;
+      }
+    } else {
+      pSource->Backoff = BSP_STORM_MIN_BACKOFF;
+    }
+    pSource->Time     = Time + pSource->Backoff;
+    pSource->IsMasked = 1u;
+    _NumMasked++;
+    _Log(IRQIndex, BSP_STORM_EVENT_MASKED, pSource->NumIRQs, pSource->Backoff);
+    OS_INT_DecRI();
+    OS_TASKEVENT_Set(&_Task, BSP_STORM_TASKEVENT);
+  }
+}
+
+/*********************************************************************
+*
+*       BSP_STORM_IsMasked()
+*
+*  Return value
+*    == 0: IRQ is served by interrupt.
+*    != 0: IRQ is masked and polled because of a storm.
+*/
+OS_BOOL BSP_STORM_IsMasked(OS_U32 IRQIndex) {
+  if (IRQIndex >= NUM_IRQS) {
+    return 0u;
+  }
+  return _aSource[IRQIndex].IsMasked;
+}
+
+/*********************************************************************
+*
+*       BSP_STORM_GetLog()
+*
+*  Function description
+*    Copies the latest storm events, oldest first.
+*
+*  Parameters
+*    paEntry:    Array which receives the log entries.
+*    MaxEntries: Number of entries paEntry can hold.
+*
+*  Return value
+*    Total number of events logged since startup. Only the latest
+*    BSP_STORM_LOG_SIZE of them are kept.
+*/
+OS_U32 BSP_STORM_GetLog(BSP_STORM_LOG_ENTRY* paEntry, OS_U32 MaxEntries) {
+  OS_U32 NumLogged;
+  OS_U32 NumEntries;
+  OS_U32 i;
+
+  OS_INT_IncDI();
+  NumLogged  = _NumLogged;
+  NumEntries = (NumLogged < BSP_STORM_LOG_SIZE) ? NumLogged : BSP_STORM_LOG_SIZE;
+  if (NumEntries > MaxEntries) {
+    NumEntries = MaxEntries;
+  }
+  for (i = 0u; i < NumEntries; i++) {
+    paEntry[i] = _aLog[(NumLogged - NumEntries + i) % BSP_STORM_LOG_SIZE];
+  }
+  OS_INT_DecRI();
+  return NumLogged;
+}
+
+#endif  // IRQ_STORM_DETECTION
+
+/*************************** End of file ****************************/
@@ -0,0 +1,471 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 1995 - 2022 SEGGER Microcontroller GmbH                  *
+*                                                                    *
+*       Internet: segger.com  Support: support_embos@segger.com      *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       embOS * Real time operating system                           *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product or a real-time            *
+*       operating system for in-house use.                           *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       OS version: V5.18.0.0                                        *
+*                                                                    *
+**********************************************************************
+
+-------------------------- END-OF-HEADER -----------------------------
+File    : BSP_Log.c
+Purpose : Deferred logging, output of _write() via a lock-free ring.
+
+Additional information:
+  _write() copies its data into a ring of fixed-size chunks and returns,
+  so that printf() and friends cost a copy but no UART access in the
+  calling task or ISR. The ring is lock-free in the same way as
+  BSP_DeferredWork.c: each chunk carries a sequence number, a producer
+  reserves as many consecutive chunks as it needs by advancing the
+  write position with a compare-and-swap and publishes each chunk by
+  updating its sequence number. Writes of concurrent producers are
+  therefore never interleaved.
+
+  The ring is flushed to BSP_LOG_UART either by a flush task of low
+  priority or, if no flush task is used, from OS_Idle(). The flush task
+  is signaled only by the write which the flusher may be waiting for,
+  as in BSP_DeferredWork.c.
+
+  When a write does not fit into the ring, BSP_LOG_DROP_NEWEST discards
+  it as a whole, while BSP_LOG_DROP_OLDEST discards the oldest published
+  chunks until it fits. Discarding producers claim chunks via a
+  compare-and-swap on the read position, as the flusher does. Only the
+  chunk which blocks the reservation is discarded, and only if it is
+  the published chunk at the read position. If it is still being
+  written or was taken by the flusher, the new write is discarded
+  instead, as chunks behind it would not make room.
+*/
+
+#include <string.h>
+#include "BSP_Log.h"
+
+#if (DEFERRED_LOG != 0)
+
+/*********************************************************************
+*
+*       Defines
+*
+**********************************************************************
+*/
+#define CHUNK_MASK  (BSP_LOG_NUM_CHUNKS - 1u)
+#define RING_SIZE   (BSP_LOG_NUM_CHUNKS * BSP_LOG_CHUNK_SIZE)
+
+/*********************************************************************
+*
+*       Types, local
+*
+**********************************************************************
+*/
+typedef struct {
+  OS_U32 Seq;  // == Position: free, == Position + 1: published
+  OS_U32 Len;
+  OS_U8  aData[BSP_LOG_CHUNK_SIZE];
+} CHUNK;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static CHUNK        _aChunk[BSP_LOG_NUM_CHUNKS];
+static OS_U32       _WrPos;       // Next position to be reserved by a producer
+static OS_U32       _RdPos;       // Next position to be flushed, advanced by the flusher and by discarding producers
+static OS_U8        _aPending[BSP_LOG_CHUNK_SIZE];  // Chunk taken by the flusher, not yet accepted by the UART
+static OS_U32       _NumPending;
+static OS_U32       _PendingOff;
+static BSP_LOG_STAT _Stat;
+static OS_BOOL      _IsInited;
+static OS_BOOL      _UseTask;
+static OS_TASK      _Task;
+static OS_STACKPTR OS_U32 _aStack[BSP_LOG_STACK_SIZE];
+
+/*********************************************************************
+*
+*       Local functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       _UpdateMax()
+*
+*  Function description
+*    Raises *pMax to Value, safe against concurrent producers.
+*/
+static void _UpdateMax(OS_U32* pMax, OS_U32 Value) {
+  OS_U32 Max;
+
+  Max = __atomic_load_n(pMax, __ATOMIC_RELAXED);
+  while (Value > Max) {
+    if (__atomic_compare_exchange_n(pMax, &Max, Value, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+      break;
+    }
+  }
+}
+
+/*********************************************************************
+*
+*       _CheckFree()
+*
+*  Function description
+*    Checks whether NumChunks chunks starting at Pos are free.
+*
+*  Parameters
+*    Pos:       Position of the first chunk.
+*    NumChunks: Number of chunks.
+*    pBlockPos: Receives the position of the previous round held by
+*               the first chunk which is not free, if the ring is full.
+*
+*  Return value
+*    == 0: All chunks are free.
+*    >  0: A chunk was reserved by a preempting producer, Pos is stale.
+*    <  0: A chunk still holds data of the previous round, ring is full.
+*
+*  Additional information
+*    Chunks are not necessarily released in order, as a discarding
+*    producer may preempt the flusher, hence each chunk is checked.
+*/
+static OS_I32 _CheckFree(OS_U32 Pos, OS_U32 NumChunks, OS_U32* pBlockPos) {
+  OS_I32 Diff;
+  OS_U32 i;
+
+  for (i = 0u; i < NumChunks; i++) {
+    Diff = (OS_I32)(__atomic_load_n(&_aChunk[(Pos + i) & CHUNK_MASK].Seq, __ATOMIC_ACQUIRE) - (Pos + i));
+    if (Diff != 0) {
+      *pBlockPos = Pos + i - BSP_LOG_NUM_CHUNKS;
+      return Diff;
+    }
+  }
+  return 0;
+}
+
+/*********************************************************************
+*
+*       _Claim()
+*
+*  Function description
+*    Claims the oldest published chunk by advancing the read position.
+*
+*  Return value
+*    NULL: Ring is empty, or the oldest chunk is still being written.
+*    else: Pointer to the claimed chunk, *pPos is its position.
+*/
+static CHUNK* _Claim(OS_U32* pPos) {
+  CHUNK* pChunk;
+  OS_U32 Pos;
+
+  Pos = __atomic_load_n(&_RdPos, __ATOMIC_ACQUIRE);
+  do {
+    pChunk = &_aChunk[Pos & CHUNK_MASK];
+    if (__atomic_load_n(&pChunk->Seq, __ATOMIC_ACQUIRE) != (Pos + 1u)) {
+      return NULL;
+    }
+  } while (__atomic_compare_exchange_n(&_RdPos, &Pos, Pos + 1u, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) == 0);
+  *pPos = Pos;
+  return pChunk;
+}
+
+/*********************************************************************
+*
+*       _Release()
+*
+*  Function description
+*    Releases a claimed chunk for the next round.
+*/
+static void _Release(CHUNK* pChunk, OS_U32 Pos) {
+  __atomic_store_n(&pChunk->Seq, Pos + BSP_LOG_NUM_CHUNKS, __ATOMIC_RELEASE);
+}
+
+/*********************************************************************
+*
+*       _Flush()
+*
+*  Function description
+*    Passes pending chunks to the UART until the ring is empty or the
+*    TX ring of the UART is full.
+*
+*  Return value
+*    == 0: Ring is empty.
+*    != 0: UART is busy, the remaining chunks need to be flushed later.
+*
+*  Additional information
+*    Called by the single flusher only, which is either the flush task
+*    or OS_Idle().
+*/
+static int _Flush(void) {
+  CHUNK*       pChunk;
+  OS_U32       Pos;
+  unsigned int NumBytes;
+
+  do {
+    while (_PendingOff < _NumPending) {
+      NumBytes = BSP_UART_Write(BSP_LOG_UART, &_aPending[_PendingOff], _NumPending - _PendingOff);
+      if (NumBytes == 0u) {
+        return 1;
+      }
+      _PendingOff += NumBytes;
+      __atomic_fetch_add(&_Stat.NumFlushed, NumBytes, __ATOMIC_RELAXED);
+    }
+    pChunk = _Claim(&Pos);
+    if (pChunk == NULL) {
+      return 0;
+    }
+    _NumPending = pChunk->Len;
+    _PendingOff = 0u;
+    memcpy(_aPending, pChunk->aData, _NumPending);
+    _Release(pChunk, Pos);  // Copying the chunk releases it before the UART accepted it
+  } while (1);
+}
+
+#if (BSP_LOG_POLICY == BSP_LOG_DROP_OLDEST)
+/*********************************************************************
+*
+*       _DiscardOldest()
+*
+*  Function description
+*    Discards the chunk which blocks a reservation, if _Claim() would
+*    take it next.
+*
+*  Parameters
+*    Pos: Position of the blocking chunk, see _CheckFree().
+*
+*  Return value
+*    == 0: Nothing can be discarded, the new write is to be discarded.
+*    != 0: The read position advanced, the reservation may be retried.
+*
+*  Additional information
+*    A blocking chunk behind the read position was claimed, but not
+*    released yet. Discarding the chunks after it would not make room,
+*    hence it would wipe the ring.
+*/
+static int _DiscardOldest(OS_U32 Pos) {
+  CHUNK* pChunk;
+  OS_U32 RdPos;
+
+  RdPos = __atomic_load_n(&_RdPos, __ATOMIC_ACQUIRE);
+  if (RdPos != Pos) {
+    return 0;                // Taken by the flusher or a discarding producer
+  }
+  pChunk = &_aChunk[Pos & CHUNK_MASK];
+  if (__atomic_load_n(&pChunk->Seq, __ATOMIC_ACQUIRE) != (Pos + 1u)) {
+    return 0;                // Still being written
+  }
+  if (__atomic_compare_exchange_n(&_RdPos, &RdPos, Pos + 1u, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) == 0) {
+    return 1;                // Claimed concurrently, the reservation checks again
+  }
+  _Release(pChunk, Pos);
+  __atomic_fetch_add(&_Stat.NumDiscarded, 1u, __ATOMIC_RELAXED);
+  return 1;
+}
+#endif
+
+/*********************************************************************
+*
+*       _FlushTask()
+*
+*  Function description
+*    Flush task. While the UART is busy, it polls once per system tick
+*    instead of being signaled by the UART interrupt.
+*/
+static void _FlushTask(void) {
+  while (1) {
+    if (_Flush() != 0) {
+      OS_TASK_Delay(1);
+    } else {
+      (void)OS_TASKEVENT_GetBlocked(BSP_LOG_TASKEVENT);
+    }
+  }
+}
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       BSP_LOG_Init()
+*
+*  Function description
+*    Initializes the log ring and creates the flush task.
+*
+*  Parameters
+*    Priority: embOS priority of the flush task. With 0, no task is
+*              created and the ring is flushed from OS_Idle().
+*
+*  Additional information
+*    Output written before BSP_LOG_Init() is discarded and not counted.
+*/
+void BSP_LOG_Init(OS_PRIO Priority) {
+  OS_U32 i;
+
+  for (i = 0u; i < BSP_LOG_NUM_CHUNKS; i++) {
+    _aChunk[i].Seq = i;
+  }
+  _WrPos      = 0u;
+  _RdPos      = 0u;
+  _NumPending = 0u;
+  _PendingOff = 0u;
+  BSP_LOG_ResetStat();
+  _UseTask = (Priority != 0u) ? 1u : 0u;
+  if (_UseTask != 0u) {
+    OS_TASK_Create(&_Task, "Log", Priority, _FlushTask, _aStack, sizeof(_aStack), 2u);
+  }
+  __atomic_store_n(&_IsInited, 1u, __ATOMIC_RELEASE);
+}
+
+/*********************************************************************
+*
+*       BSP_LOG_Write()
+*
+*  Function description
+*    Queues data for output by the flusher.
+*
+*  Parameters
+*    pData:    Data to be written.
+*    NumBytes: Number of bytes to be written.
+*
+*  Return value
+*    NumBytes, also if the data was discarded, so that libc does not
+*    retry or report an error.
+*
+*  Additional information
+*    May be called from tasks and embOS ISRs, including nested ones.
+*    Its cost is the reservation and a copy of the data, the UART is
+*    not accessed. With a flush task, it may call OS_TASKEVENT_Set(),
+*    hence zero-latency ISRs may write only if the ring is flushed from
+*    OS_Idle(). Writes exceeding the ring size are truncated.
+*/
+int BSP_LOG_Write(const char* pData, int NumBytes) {
+  CHUNK* pChunk;
+  OS_U32 Len;
+  OS_U32 NumChunks;
+  OS_U32 Pos;
+  OS_U32 RdPos;
+  OS_U32 BlockPos;
+  OS_U32 i;
+  OS_I32 Diff;
+
+  if ((NumBytes <= 0) || (__atomic_load_n(&_IsInited, __ATOMIC_ACQUIRE) == 0u)) {
+    return NumBytes;
+  }
+  Len = (OS_U32)NumBytes;
+  if (Len > RING_SIZE) {
+    __atomic_fetch_add(&_Stat.NumDroppedBytes, Len - RING_SIZE, __ATOMIC_RELAXED);
+    Len = RING_SIZE;
+  }
+  NumChunks = (Len + BSP_LOG_CHUNK_SIZE - 1u) / BSP_LOG_CHUNK_SIZE;
+  Pos       = __atomic_load_n(&_WrPos, __ATOMIC_RELAXED);
+  while (1) {
+    Diff = _CheckFree(Pos, NumChunks, &BlockPos);
+    if (Diff == 0) {
+      if (__atomic_compare_exchange_n(&_WrPos, &Pos, Pos + NumChunks, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        break;                                          // Chunks reserved
+      }                                                 // Else Pos was updated by the failed exchange
+    } else if (Diff > 0) {
+      Pos = __atomic_load_n(&_WrPos, __ATOMIC_RELAXED);  // Chunks were reserved by a preempting producer
+    } else {
+#if (BSP_LOG_POLICY == BSP_LOG_DROP_OLDEST)
+      if (_DiscardOldest(BlockPos) != 0) {
+        continue;
+      }
+#endif
+      __atomic_fetch_add(&_Stat.NumOverflows, 1u, __ATOMIC_RELAXED);
+      __atomic_fetch_add(&_Stat.NumDroppedBytes, Len, __ATOMIC_RELAXED);
+      return NumBytes;
+    }
+  }
+  __atomic_fetch_add(&_Stat.NumBytes, Len, __ATOMIC_RELAXED);
+  for (i = 0u; i < NumChunks; i++) {
+    pChunk      = &_aChunk[(Pos + i) & CHUNK_MASK];
+    pChunk->Len = (Len < BSP_LOG_CHUNK_SIZE) ? Len : BSP_LOG_CHUNK_SIZE;
+    memcpy(pChunk->aData, pData, pChunk->Len);
+    pData += pChunk->Len;
+    Len   -= pChunk->Len;
+    __atomic_store_n(&pChunk->Seq, Pos + i + 1u, __ATOMIC_RELEASE);  // Publish
+  }
+  RdPos = __atomic_load_n(&_RdPos, __ATOMIC_ACQUIRE);  // Read position first, it never passes the write position
+  _UpdateMax(&_Stat.MaxDepth, __atomic_load_n(&_WrPos, __ATOMIC_RELAXED) - RdPos);
+  //
+  // The flusher may be waiting for one of these chunks only if the read
+  // position points into them. Otherwise it either did not reach them
+  // yet, and the write it waits for signals it, or it took them already.
+  //
+  if (_UseTask != 0u) {
+    if ((__atomic_load_n(&_RdPos, __ATOMIC_ACQUIRE) - Pos) < NumChunks) {
+      OS_TASKEVENT_Set(&_Task, BSP_LOG_TASKEVENT);
+    }
+  }
+  return NumBytes;
+}
+
+/*********************************************************************
+*
+*       BSP_LOG_OnIdle()
+*
+*  Function description
+*    Flushes the log ring if no flush task is used.
+*
+*  Additional information
+*    Called by OS_Idle() on each iteration of the idle loop. While the
+*    UART is busy, its TX interrupt wakes the CPU for the next attempt.
+*/
+void BSP_LOG_OnIdle(void) {
+  if ((_UseTask == 0u) && (__atomic_load_n(&_IsInited, __ATOMIC_ACQUIRE) != 0u)) {
+    (void)_Flush();
+  }
+}
+
+/*********************************************************************
+*
+*       BSP_LOG_GetStat()
+*
+*  Function description
+*    Returns a consistent copy of the log statistics.
+*/
+void BSP_LOG_GetStat(BSP_LOG_STAT* pStat) {
+  OS_INT_IncDI();
+  *pStat = _Stat;
+  OS_INT_DecRI();
+}
+
+/*********************************************************************
+*
+*       BSP_LOG_ResetStat()
+*/
+void BSP_LOG_ResetStat(void) {
+  OS_INT_IncDI();
+  _Stat.NumBytes        = 0u;
+  _Stat.NumFlushed      = 0u;
+  _Stat.NumOverflows    = 0u;
+  _Stat.NumDroppedBytes = 0u;
+  _Stat.NumDiscarded    = 0u;
+  _Stat.MaxDepth        = 0u;
+  OS_INT_DecRI();
+}
+
+#endif  // DEFERRED_LOG
+
+/*************************** End of file ****************************/
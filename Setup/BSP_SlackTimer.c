@@ -0,0 +1,355 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 1995 - 2022 SEGGER Microcontroller GmbH                  *
+*                                                                    *
+*       Internet: segger.com  Support: support_embos@segger.com      *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       embOS * Real time operating system                           *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product or a real-time            *
+*       operating system for in-house use.                           *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       OS version: V5.18.0.0                                        *
+*                                                                    *
+**********************************************************************
+
+-------------------------- END-OF-HEADER -----------------------------
+File    : BSP_SlackTimer.c
+Purpose : Software timers with per-timer slack, coalesced into few wakeups.
+
+Additional information:
+  Each timer expires within the window [Earliest, Latest], where
+  Latest = Earliest + Slack. All active timers are served by a single
+  embOS software timer, which is programmed to the earliest Latest of
+  all timers. When it expires, every timer whose window has opened
+  is expired as well. Timers with overlapping windows are therefore
+  handled by one wakeup instead of one wakeup each.
+
+  As the service timer is an embOS software timer, tickless idle
+  takes it into account and sleeps until the next batch is due.
+
+  Timer routines use the OS_TIMER_EX signature and are called from the
+  embOS software timer context. Expired timers are chained via their
+  own link and marked pending until their routine is called, so that
+  a routine may start or stop any timer of the same batch.
+*/
+
+#include "BSP_SlackTimer.h"
+
+#if (SLACK_TIMER != 0)
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static OS_TIMER_EX      _Timer;   // Service timer, expires at the earliest Latest
+static BSP_SLACK_TIMER* _pFirst;  // Active timers, sorted by Latest
+static BSP_SLACK_STAT   _Stat;
+
+/*********************************************************************
+*
+*       Local functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       _Arm()
+*
+*  Function description
+*    Programs the service timer for the first timer in the list.
+*
+*  Additional information
+*    Must be called with interrupts disabled.
+*/
+static void _Arm(void) {
+  OS_TIME Period;
+
+  if (_pFirst == NULL) {
+    OS_TIMER_StopEx(&_Timer);
+  } else {
+    Period = _pFirst->Latest - OS_TIME_GetTicks();
+    if (Period < 1) {
+      Period = 1;
+    }
+    OS_TIMER_SetPeriodEx(&_Timer, Period);
+    OS_TIMER_RestartEx(&_Timer);
+  }
+}
+
+/*********************************************************************
+*
+*       _Unlink()
+*
+*  Return value
+*    == 0: Timer was not the first one.
+*    != 0: Timer was the first one, the service timer must be updated.
+*/
+static int _Unlink(BSP_SLACK_TIMER* pTimer) {
+  BSP_SLACK_TIMER** ppLink;
+
+  ppLink = &_pFirst;
+  while (*ppLink != NULL) {
+    if (*ppLink == pTimer) {
+      *ppLink        = pTimer->pNext;
+      pTimer->Active = 0u;
+      return (ppLink == &_pFirst) ? 1 : 0;
+    }
+    ppLink = &(*ppLink)->pNext;
+  }
+  return 0;
+}
+
+/*********************************************************************
+*
+*       _OnTimer()
+*
+*  Function description
+*    Service timer routine. Expires all timers whose window has opened.
+*/
+static void _OnTimer(void* pData) {
+  BSP_SLACK_TIMER** ppLink;
+  BSP_SLACK_TIMER*  pTimer;
+  BSP_SLACK_TIMER*  pExpired;
+  BSP_SLACK_TIMER** ppExpiredLast;
+  OS_TIME           Now;
+  OS_BOOL           IsPending;
+
+  OS_USE_PARA(pData);
+  pExpired      = NULL;
+  ppExpiredLast = &pExpired;
+  OS_INT_IncDI();
+  Now    = OS_TIME_GetTicks();
+  ppLink = &_pFirst;
+  while (*ppLink != NULL) {
+    pTimer = *ppLink;
+    if ((Now - pTimer->Earliest) >= 0) {
+      *ppLink              = pTimer->pNext;  // Move to the list of expired timers, keeping the order
+      pTimer->Active       = 0u;
+      pTimer->Pending      = 1u;
+      pTimer->pNextExpired = NULL;
+      *ppExpiredLast       = pTimer;
+      ppExpiredLast        = &pTimer->pNextExpired;
+      _Stat.NumExpired++;
+    } else {
+      ppLink = &pTimer->pNext;
+    }
+  }
+  _Stat.NumWakeups++;
+  _Arm();
+  OS_INT_DecRI();
+  //
+  // Call the timer routines outside of the critical section. They may
+  // start or stop timers, including the one which just expired. A
+  // pending timer which was started or stopped meanwhile is skipped,
+  // as its expiration was superseded.
+  //
+  while (pExpired != NULL) {
+    pTimer   = pExpired;
+    pExpired = pTimer->pNextExpired;
+    OS_INT_IncDI();
+    IsPending       = pTimer->Pending;
+    pTimer->Pending = 0u;
+    OS_INT_DecRI();
+    if (IsPending != 0u) {
+      pTimer->pfTimerRoutine(pTimer->pData);
+    }
+  }
+}
+
+/*********************************************************************
+*
+*       _WakeTask()
+*
+*  Function description
+*    Timer routine used by BSP_SLACK_Delay().
+*/
+static void _WakeTask(void* pData) {
+  OS_TASKEVENT_Set((OS_TASK*)pData, BSP_SLACK_TASKEVENT);
+}
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       BSP_SLACK_Init()
+*
+*  Function description
+*    Creates the service timer. Must be called once after OS_Init(),
+*    before any other function of this module.
+*/
+void BSP_SLACK_Init(void) {
+  OS_TIMER_CreateEx(&_Timer, _OnTimer, 1, NULL);
+}
+
+/*********************************************************************
+*
+*       BSP_SLACK_Create()
+*
+*  Function description
+*    Creates a timer. The timer is not started.
+*
+*  Parameters
+*    pTimer:         Pointer to a timer object.
+*    pfTimerRoutine: Routine which is called when the timer expires.
+*    Period:         Minimum period in ticks, >= 1.
+*    Slack:          Number of ticks by which the expiration may be
+*                    delayed to share a wakeup with other timers, >= 0.
+*    pData:          Parameter passed to pfTimerRoutine.
+*/
+void BSP_SLACK_Create(BSP_SLACK_TIMER* pTimer, OS_ROUTINE_VOID_PTR* pfTimerRoutine, OS_TIME Period, OS_TIME Slack, void* pData) {
+  pTimer->pfTimerRoutine = pfTimerRoutine;
+  pTimer->pData          = pData;
+  pTimer->Active         = 0u;
+  pTimer->Pending        = 0u;
+  BSP_SLACK_SetPeriod(pTimer, Period, Slack);
+}
+
+/*********************************************************************
+*
+*       BSP_SLACK_Start()
+*
+*  Function description
+*    Starts a timer. A timer which is already active is not affected.
+*
+*  Additional information
+*    May be called from tasks, software timers and interrupts. A timer
+*    which expired but whose routine was not yet called is started
+*    anew, and the routine of that expiration is not called.
+*/
+void BSP_SLACK_Start(BSP_SLACK_TIMER* pTimer) {
+  BSP_SLACK_TIMER** ppLink;
+
+  OS_INT_IncDI();
+  pTimer->Pending = 0u;
+  if (pTimer->Active == 0u) {
+    pTimer->Earliest = OS_TIME_GetTicks() + pTimer->Period;
+    pTimer->Latest   = pTimer->Earliest + pTimer->Slack;
+    pTimer->Active   = 1u;
+    ppLink = &_pFirst;
+    while ((*ppLink != NULL) && (((*ppLink)->Latest - pTimer->Latest) <= 0)) {
+      ppLink = &(*ppLink)->pNext;
+    }
+    pTimer->pNext = *ppLink;
+    *ppLink       = pTimer;
+    if (ppLink == &_pFirst) {
+      _Arm();
+    }
+  }
+  OS_INT_DecRI();
+}
+
+/*********************************************************************
+*
+*       BSP_SLACK_Stop()
+*
+*  Function description
+*    Stops a timer. The timer routine is not called afterwards.
+*/
+void BSP_SLACK_Stop(BSP_SLACK_TIMER* pTimer) {
+  OS_INT_IncDI();
+  pTimer->Pending = 0u;
+  if (pTimer->Active != 0u) {
+    if (_Unlink(pTimer) != 0) {
+      _Arm();
+    }
+  }
+  OS_INT_DecRI();
+}
+
+/*********************************************************************
+*
+*       BSP_SLACK_Restart()
+*
+*  Function description
+*    Restarts a timer with its period and slack, whether it is active
+*    or not. Typically called from the timer routine for periodic timers.
+*/
+void BSP_SLACK_Restart(BSP_SLACK_TIMER* pTimer) {
+  OS_INT_IncDI();
+  BSP_SLACK_Stop(pTimer);
+  BSP_SLACK_Start(pTimer);
+  OS_INT_DecRI();
+}
+
+/*********************************************************************
+*
+*       BSP_SLACK_SetPeriod()
+*
+*  Function description
+*    Sets period and slack used by the next start or restart of a timer.
+*/
+void BSP_SLACK_SetPeriod(BSP_SLACK_TIMER* pTimer, OS_TIME Period, OS_TIME Slack) {
+  pTimer->Period = (Period > 0) ? Period : 1;
+  pTimer->Slack  = (Slack  > 0) ? Slack  : 0;
+}
+
+/*********************************************************************
+*
+*       BSP_SLACK_GetStatus()
+*
+*  Return value
+*    == 0: Timer is not active.
+*    != 0: Timer is active.
+*/
+OS_BOOL BSP_SLACK_GetStatus(const BSP_SLACK_TIMER* pTimer) {
+  return pTimer->Active;
+}
+
+/*********************************************************************
+*
+*       BSP_SLACK_Delay()
+*
+*  Function description
+*    Suspends the calling task for at least Period and at most
+*    Period + Slack ticks.
+*
+*  Additional information
+*    Uses the task event BSP_SLACK_TASKEVENT, which must not be used
+*    otherwise by the calling task.
+*/
+void BSP_SLACK_Delay(OS_TIME Period, OS_TIME Slack) {
+  BSP_SLACK_TIMER Timer;
+
+  BSP_SLACK_Create(&Timer, _WakeTask, Period, Slack, OS_TASK_GetID());
+  BSP_SLACK_Start(&Timer);
+  (void)OS_TASKEVENT_GetBlocked(BSP_SLACK_TASKEVENT);
+}
+
+/*********************************************************************
+*
+*       BSP_SLACK_GetStat()
+*
+*  Function description
+*    Returns the number of wakeups and expired timers. Their ratio is
+*    the average number of timers served per wakeup.
+*/
+void BSP_SLACK_GetStat(BSP_SLACK_STAT* pStat) {
+  OS_INT_IncDI();
+  *pStat = _Stat;
+  OS_INT_DecRI();
+}
+
+#endif  // SLACK_TIMER
+
+/*************************** End of file ****************************/
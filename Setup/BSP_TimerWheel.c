@@ -0,0 +1,401 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 1995 - 2022 SEGGER Microcontroller GmbH                  *
+*                                                                    *
+*       Internet: segger.com  Support: support_embos@segger.com      *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       embOS * Real time operating system                           *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product or a real-time            *
+*       operating system for in-house use.                           *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       OS version: V5.18.0.0                                        *
+*                                                                    *
+**********************************************************************
+
+-------------------------- END-OF-HEADER -----------------------------
+File    : BSP_TimerWheel.c
+Purpose : Hierarchical timing wheel for large numbers of software timers.
+
+Additional information:
+  embOS keeps active software timers in a single sorted list, hence
+  starting a timer costs O(n) with n active timers. This module keeps
+  timers in a hierarchical timing wheel with BSP_TWHEEL_NUM_LEVELS
+  levels of BSP_TWHEEL_NUM_SLOTS slots each, which is advanced by a
+  tick hook:
+    - Start and stop are O(1): a timer is linked into the slot
+      selected by its expiration time, or unlinked from it.
+    - Expire is O(1) per timer: each tick only the current slot of
+      level 0 is processed. Every 64^n ticks the current slot of
+      level n is moved down (cascaded) to the lower levels.
+  Timers with a period beyond the range of the wheel are parked in the
+  last slot of the top level and re-queued when it is cascaded.
+
+  The wheel may lag behind the embOS time, e.g. after tickless idle was
+  ended by another interrupt, until the next tick hook catches it up.
+  Expiration times are therefore based on OS_TIME_GetTicks(), not on
+  the wheel position.
+
+  Timer routines use the OS_TIMER_EX signature and are called from the
+  system tick interrupt, like embOS software timers.
+*/
+
+#include "BSP_TimerWheel.h"
+
+#if (TIMER_WHEEL != 0)
+
+/*********************************************************************
+*
+*       Defines
+*
+**********************************************************************
+*/
+#define SLOT_MASK   (BSP_TWHEEL_NUM_SLOTS - 1u)
+#define MAX_DELTA   ((1uL << (BSP_TWHEEL_SLOT_BITS * BSP_TWHEEL_NUM_LEVELS)) - 1u)  // Largest delta which fits into the wheel
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static BSP_TWHEEL_LINK _aSlot[BSP_TWHEEL_NUM_LEVELS][BSP_TWHEEL_NUM_SLOTS];  // List heads
+static OS_U32          _Now;        // Wheel tick which was processed last
+static OS_U32          _NumActive;  // Number of active timers
+static OS_TICK_HOOK    _TickHook;
+
+/*********************************************************************
+*
+*       Local functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       _Link()
+*
+*  Function description
+*    Links a timer into the slot selected by its expiration time.
+*/
+static void _Link(BSP_TWHEEL_TIMER* pTimer) {
+  BSP_TWHEEL_LINK* pHead;
+  OS_U32           Expire;
+  OS_U32           Delta;
+  unsigned         Level;
+
+  Expire = pTimer->Expire;
+  Delta  = Expire - _Now;
+  if (Delta > MAX_DELTA) {  // Beyond the range of the wheel, re-queued when the slot is cascaded
+    Expire = _Now + MAX_DELTA;
+    Delta  = MAX_DELTA;
+  }
+  Level = 0u;
+  while (Delta >= (1uL << (BSP_TWHEEL_SLOT_BITS * (Level + 1u)))) {
+    Level++;
+  }
+  pHead = &_aSlot[Level][(Expire >> (BSP_TWHEEL_SLOT_BITS * Level)) & SLOT_MASK];
+  pTimer->Link.pNext  = pHead;  // Append, timers of the same tick expire in the order they were started
+  pTimer->Link.pPrev  = pHead->pPrev;
+  pHead->pPrev->pNext = &pTimer->Link;
+  pHead->pPrev        = &pTimer->Link;
+}
+
+/*********************************************************************
+*
+*       _Unlink()
+*/
+static void _Unlink(BSP_TWHEEL_TIMER* pTimer) {
+  pTimer->Link.pPrev->pNext = pTimer->Link.pNext;
+  pTimer->Link.pNext->pPrev = pTimer->Link.pPrev;
+}
+
+/*********************************************************************
+*
+*       _Cascade()
+*
+*  Function description
+*    Moves all timers of a slot down to the lower levels.
+*/
+static void _Cascade(unsigned Level) {
+  BSP_TWHEEL_LINK*  pHead;
+  BSP_TWHEEL_TIMER* pTimer;
+
+  pHead = &_aSlot[Level][(_Now >> (BSP_TWHEEL_SLOT_BITS * Level)) & SLOT_MASK];
+  while (pHead->pNext != pHead) {
+    pTimer = (BSP_TWHEEL_TIMER*)pHead->pNext;
+    _Unlink(pTimer);
+    _Link(pTimer);  // Never links into the slot being cascaded
+  }
+}
+
+/*********************************************************************
+*
+*       _Advance()
+*
+*  Function description
+*    Advances the wheel by one tick and calls the routines of all
+*    timers which expire with this tick.
+*/
+static void _Advance(void) {
+  BSP_TWHEEL_LINK*  pHead;
+  BSP_TWHEEL_TIMER* pTimer;
+  unsigned          Level;
+
+  _Now++;
+  //
+  // Find the highest level which needs to be cascaded and cascade
+  // top-down, so timers can move down several levels within one tick.
+  //
+  Level = 1u;
+  while ((Level < BSP_TWHEEL_NUM_LEVELS) && ((_Now & ((1uL << (BSP_TWHEEL_SLOT_BITS * Level)) - 1u)) == 0u)) {
+    Level++;
+  }
+  while (--Level > 0u) {
+    _Cascade(Level);
+  }
+  //
+  // Expire all timers of the current level 0 slot. Timers started by a
+  // timer routine never link into this slot, as their period is > 0.
+  //
+  pHead = &_aSlot[0][_Now & SLOT_MASK];
+  while (pHead->pNext != pHead) {
+    pTimer = (BSP_TWHEEL_TIMER*)pHead->pNext;
+    _Unlink(pTimer);
+    pTimer->Active = 0u;
+    _NumActive--;
+    pTimer->pfTimerRoutine(pTimer->pData);
+  }
+}
+
+/*********************************************************************
+*
+*       _OnTick()
+*
+*  Function description
+*    Tick hook. Advances the wheel up to the current embOS time.
+*
+*  Additional information
+*    Several ticks are processed if the hook was not called for every
+*    tick, e.g. after tickless idle or a bulk tick catch-up.
+*/
+static void _OnTick(void) {
+  OS_U32 Target;
+
+  Target = (OS_U32)OS_TIME_GetTicks();
+  while (_Now != Target) {
+    if (_NumActive == 0u) {
+      _Now = Target;  // Nothing to expire or cascade
+      break;
+    }
+    _Advance();
+  }
+}
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       BSP_TWHEEL_Init()
+*
+*  Function description
+*    Initializes the timing wheel and registers its tick hook.
+*
+*  Additional information
+*    Must be called once after OS_Init(), before any other function of
+*    this module.
+*/
+void BSP_TWHEEL_Init(void) {
+  unsigned Level;
+  unsigned Slot;
+
+  for (Level = 0u; Level < BSP_TWHEEL_NUM_LEVELS; Level++) {
+    for (Slot = 0u; Slot < BSP_TWHEEL_NUM_SLOTS; Slot++) {
+      _aSlot[Level][Slot].pNext = &_aSlot[Level][Slot];
+      _aSlot[Level][Slot].pPrev = &_aSlot[Level][Slot];
+    }
+  }
+  _NumActive = 0u;
+  _Now       = (OS_U32)OS_TIME_GetTicks();
+  OS_TICK_AddHook(&_TickHook, _OnTick);
+}
+
+/*********************************************************************
+*
+*       BSP_TWHEEL_Create()
+*
+*  Function description
+*    Creates a timer. The timer is not started.
+*
+*  Parameters
+*    pTimer:         Pointer to a timer object.
+*    pfTimerRoutine: Routine which is called when the timer expires.
+*    Period:         Period in ticks, 1 ... BSP_TWHEEL_MAX_PERIOD.
+*    pData:          Parameter passed to pfTimerRoutine.
+*/
+void BSP_TWHEEL_Create(BSP_TWHEEL_TIMER* pTimer, OS_ROUTINE_VOID_PTR* pfTimerRoutine, OS_TIME Period, void* pData) {
+  pTimer->pfTimerRoutine = pfTimerRoutine;
+  pTimer->pData          = pData;
+  pTimer->Period         = (Period > 0) ? Period : 1;
+  pTimer->Active         = 0u;
+}
+
+/*********************************************************************
+*
+*       BSP_TWHEEL_Start()
+*
+*  Function description
+*    Starts a timer. A timer which is already active is not affected.
+*
+*  Additional information
+*    May be called from tasks, interrupts and timer routines.
+*/
+void BSP_TWHEEL_Start(BSP_TWHEEL_TIMER* pTimer) {
+  OS_INT_IncDI();
+  if (pTimer->Active == 0u) {
+    pTimer->Expire = (OS_U32)OS_TIME_GetTicks() + (OS_U32)pTimer->Period;  // Linked relative to _Now, so a lagging wheel catches up in time
+    pTimer->Active = 1u;
+    _NumActive++;
+    _Link(pTimer);
+  }
+  OS_INT_DecRI();
+}
+
+/*********************************************************************
+*
+*       BSP_TWHEEL_Stop()
+*
+*  Function description
+*    Stops a timer. The timer routine is not called afterwards.
+*/
+void BSP_TWHEEL_Stop(BSP_TWHEEL_TIMER* pTimer) {
+  OS_INT_IncDI();
+  if (pTimer->Active != 0u) {
+    _Unlink(pTimer);
+    pTimer->Active = 0u;
+    _NumActive--;
+  }
+  OS_INT_DecRI();
+}
+
+/*********************************************************************
+*
+*       BSP_TWHEEL_Restart()
+*
+*  Function description
+*    Restarts a timer with its period, whether it is active or not.
+*    Typically called from the timer routine for periodic timers.
+*/
+void BSP_TWHEEL_Restart(BSP_TWHEEL_TIMER* pTimer) {
+  OS_INT_IncDI();
+  BSP_TWHEEL_Stop(pTimer);
+  BSP_TWHEEL_Start(pTimer);
+  OS_INT_DecRI();
+}
+
+/*********************************************************************
+*
+*       BSP_TWHEEL_SetPeriod()
+*
+*  Function description
+*    Sets the period used by the next start or restart of a timer.
+*/
+void BSP_TWHEEL_SetPeriod(BSP_TWHEEL_TIMER* pTimer, OS_TIME Period) {
+  pTimer->Period = (Period > 0) ? Period : 1;
+}
+
+/*********************************************************************
+*
+*       BSP_TWHEEL_GetPeriod()
+*/
+OS_TIME BSP_TWHEEL_GetPeriod(const BSP_TWHEEL_TIMER* pTimer) {
+  return pTimer->Period;
+}
+
+/*********************************************************************
+*
+*       BSP_TWHEEL_GetRemainingPeriod()
+*
+*  Return value
+*    Number of ticks until the timer expires, 0 if it is not active.
+*/
+OS_TIME BSP_TWHEEL_GetRemainingPeriod(const BSP_TWHEEL_TIMER* pTimer) {
+  OS_TIME r;
+
+  OS_INT_IncDI();
+  r = (pTimer->Active != 0u) ? (OS_TIME)(pTimer->Expire - (OS_U32)OS_TIME_GetTicks()) : 0;
+  OS_INT_DecRI();
+  return (r > 0) ? r : 0;  // Expired, but the wheel did not yet catch up
+}
+
+/*********************************************************************
+*
+*       BSP_TWHEEL_GetStatus()
+*
+*  Return value
+*    == 0: Timer is not active.
+*    != 0: Timer is active.
+*/
+OS_BOOL BSP_TWHEEL_GetStatus(const BSP_TWHEEL_TIMER* pTimer) {
+  return pTimer->Active;
+}
+
+/*********************************************************************
+*
+*       BSP_TWHEEL_GetNumActive()
+*/
+OS_U32 BSP_TWHEEL_GetNumActive(void) {
+  return _NumActive;
+}
+
+/*********************************************************************
+*
+*       BSP_TWHEEL_GetNumIdleTicks()
+*
+*  Function description
+*    Returns the number of ticks until the wheel needs to be advanced
+*    next, i.e. until the next non-empty level 0 slot or the next
+*    cascade, whichever comes first.
+*
+*  Additional information
+*    Used by OS_Idle() to limit the tickless period. Must be called
+*    with interrupts disabled. Returns 1 while the wheel lags behind
+*    the embOS time, so that the next tick catches it up.
+*/
+OS_TIME BSP_TWHEEL_GetNumIdleTicks(void) {
+  BSP_TWHEEL_LINK* pHead;
+  OS_U32           Tick;
+  OS_I32           r;
+
+  if (_NumActive == 0u) {
+    return BSP_TWHEEL_MAX_PERIOD;
+  }
+  Tick = _Now;
+  do {
+    Tick++;
+    pHead = &_aSlot[0][Tick & SLOT_MASK];
+  } while (((Tick & SLOT_MASK) != 0u) && (pHead->pNext == pHead));
+  r = (OS_I32)(Tick - (OS_U32)OS_TIME_GetTicks());
+  return (r > 1) ? (OS_TIME)r : 1;
+}
+
+#endif  // TIMER_WHEEL
+
+/*************************** End of file ****************************/
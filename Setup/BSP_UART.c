@@ -1,38 +1,756 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 1995 - 2022 SEGGER Microcontroller GmbH                  *
+*                                                                    *
+*       Internet: segger.com  Support: support_embos@segger.com      *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       embOS * Real time operating system                           *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product or a real-time            *
+*       operating system for in-house use.                           *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       OS version: V5.18.0.0                                        *
+*                                                                    *
+**********************************************************************
+
+-------------------------- END-OF-HEADER -----------------------------
+File    : BSP_UART.c
+Purpose : UART driver with per-unit TX and RX rings, used by embOSView
+          and for buffered output.
+
+Additional information:
+  Each unit has its own context with rings, callbacks and statistics.
+  The interrupt handler receives this context, hence all units share
+  one handler without branching on the unit number.
+
+  Data written via BSP_UART_Write() is queued in a TX ring. The ring
+  is drained by the TX interrupt, which refills the whole hardware
+  FIFO per interrupt. The writer only starts transmission when the
+  transmitter is idle, afterwards the TX interrupt keeps it going
+  until the ring is empty.
+
+  BSP_UART_WriteV() transmits a list of segments straight from the
+  caller's buffers. The TX interrupt serves the list after the data
+  which was queued in the TX ring before, and holds back data queued
+  afterwards until the list completed.
+
+  The RX interrupt is raised at a configurable FIFO trigger level,
+  the receive timeout interrupt for bytes below it. Both empty the
+  whole RX FIFO, either into the read callback or into an RX ring,
+  which is read via BSP_UART_Read().
+*/
+
 #include "BSP_UART.h"
 #include "RTOS.h"
+#include "RTOSInit.h"
 #include "board.h"
 
-#define BSP_UART UARTx(OS_UART)
-#define BSP_UART_IRQHandler_(__UNIT) UART##__UNIT##_isr
-#define BSP_UART_IRQHandler(__UNIT) BSP_UART_IRQHandler_(__UNIT)
+/*********************************************************************
+*
+*       Defines
+*
+**********************************************************************
+*/
+#define TX_BUFFER_MASK  (BSP_UART_TX_BUFFER_SIZE - 1u)
+#define RX_BUFFER_MASK  (BSP_UART_RX_BUFFER_SIZE - 1u)
+#define RX_ERR_INTS     (UART_INT_OE | UART_INT_FE | UART_INT_PE | UART_INT_BE)
+
+#define CLOCK_CASE(n)   case n: if (OnOff != 0u) { PERIPHERAL_ENABLE_(UART, n); } else { PERIPHERAL_DISABLE_(UART, n); } break;
+#define DEFINE_ISR(n)   void BSP_UART_IRQHandler(n)(void) { _OnIRQ(&_aUnit[n]); }
+
+#if (BSP_UART_NUM_UNITS > 5u)
+  #error "BSP_UART_NUM_UNITS exceeds the number of UARTs of the device"
+#endif
+
+/*********************************************************************
+*
+*       Types, local
+*
+**********************************************************************
+*/
+
+typedef struct {
+  UART_TypeDef*           pUART;
+  OS_U32                  IRQIndex;
+  unsigned int            Unit;
+  BSP_UART_RX_CB*         pfOnRx;      // Receives each byte in the RX interrupt, the RX ring is used if NULL
+  BSP_UART_TX_CB*         pfOnTx;      // Called by the TX interrupt once the TX ring is empty
+  unsigned long           Baudrate;
+  unsigned char           Parity;
+  OS_BOOL                 IsTxActive;  // TX interrupt is enabled and drains the ring
+  unsigned int            TxWrPos;     // Free-running, written by BSP_UART_Write() with interrupts disabled
+  unsigned int            TxRdPos;     // Free-running, written by the TX interrupt
+  unsigned int            RxWrPos;     // Free-running, written by the RX interrupt
+  unsigned int            RxRdPos;     // Free-running, written by BSP_UART_Read() with interrupts disabled
+  const OS_QUEUE_SRCLIST* paSG;        // Current segment of BSP_UART_WriteV(), NULL if none is active
+  unsigned int            NumSG;       // Number of segments including the current one
+  const OS_U8*            pSGData;     // Next byte of the current segment
+  unsigned int            SGNumRem;    // Bytes remaining in the current segment
+  unsigned int            SGPos;       // TX ring position at which the segments are sent
+  OS_EVENT*               pSGEvent;    // Set when all segments were passed to the hardware FIFO
+  BSP_UART_STAT           Stat;
+  unsigned char           aTxBuffer[BSP_UART_TX_BUFFER_SIZE];
+  unsigned char           aRxBuffer[BSP_UART_RX_BUFFER_SIZE];
+} UART_UNIT;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static UART_UNIT _aUnit[BSP_UART_NUM_UNITS];
+static const UART_IntFifoLevel _aRxLevel[] = {  // Indexed by BSP_UART_RX_LEVEL
+  UART_INT_FIFO_1_8, UART_INT_FIFO_1_4, UART_INT_FIFO_HALF, UART_INT_FIFO_3_4, UART_INT_FIFO_7_8
+};
 
-void BSP_UART_IRQHandler(OS_UART)(void)
-{
-  if (UART_IsMaskedIntActive(BSP_UART, UART_INT_RX)) {
-    OS_COM_OnRx(UART_ReceiveData(BSP_UART));
+/*********************************************************************
+*
+*       Local functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       _SetClock()
+*
+*  Function description
+*    Enables or disables the peripheral clock of a unit.
+*
+*  Additional information
+*    The peripheral macros of the device require the unit number as
+*    literal, hence one case per unit.
+*/
+static void _SetClock(unsigned int Unit, OS_BOOL OnOff) {
+  switch (Unit) {
+  CLOCK_CASE(0)
+#if (BSP_UART_NUM_UNITS > 1u)
+  CLOCK_CASE(1)
+#endif
+#if (BSP_UART_NUM_UNITS > 2u)
+  CLOCK_CASE(2)
+#endif
+#if (BSP_UART_NUM_UNITS > 3u)
+  CLOCK_CASE(3)
+#endif
+#if (BSP_UART_NUM_UNITS > 4u)
+  CLOCK_CASE(4)
+#endif
+  default:
+    break;
   }
-  if (UART_IsMaskedIntActive(BSP_UART, UART_INT_TX)) {
-    OS_COM_OnTx();
+}
+
+/*********************************************************************
+*
+*       _GetHW()
+*
+*  Function description
+*    Initializes the hardware description of a unit.
+*/
+static void _GetHW(UART_UNIT* pUnit, unsigned int Unit) {
+  static UART_TypeDef* const _apUART[] = {
+    UART0,
+#if (BSP_UART_NUM_UNITS > 1u)
+    UART1,
+#endif
+#if (BSP_UART_NUM_UNITS > 2u)
+    UART2,
+#endif
+#if (BSP_UART_NUM_UNITS > 3u)
+    UART3,
+#endif
+#if (BSP_UART_NUM_UNITS > 4u)
+    UART4,
+#endif
+  };
+  static const OS_U8 _aIRQIndex[] = {
+    UART0_IRQn,
+#if (BSP_UART_NUM_UNITS > 1u)
+    UART1_IRQn,
+#endif
+#if (BSP_UART_NUM_UNITS > 2u)
+    UART2_IRQn,
+#endif
+#if (BSP_UART_NUM_UNITS > 3u)
+    UART3_IRQn,
+#endif
+#if (BSP_UART_NUM_UNITS > 4u)
+    UART4_IRQn,
+#endif
+  };
+
+  pUnit->pUART    = _apUART[Unit];
+  pUnit->IRQIndex = _aIRQIndex[Unit];
+  pUnit->Unit     = Unit;
+}
+
+/*********************************************************************
+*
+*       _ConfigHW()
+*
+*  Function description
+*    Programs line settings, FIFO levels and interrupts of a unit.
+*/
+static void _ConfigHW(UART_UNIT* pUnit) {
+  UART_Init(pUnit->pUART, pUnit->Baudrate, UART_LCR_DATABITS_8, UART_LCR_STOPBITS_1,
+            pUnit->Parity == BSP_UART_PARITY_NONE ? UART_LCR_PARITY_NONE : pUnit->Parity == BSP_UART_PARITY_EVEN ? UART_LCR_PARITY_EVEN : UART_LCR_PARITY_ODD,
+            UART_LCR_FIFO_16);
+  UART_SetTxIntFifoLevel(pUnit->pUART, UART_INT_FIFO_1_8);
+  UART_SetRxIntFifoLevel(pUnit->pUART, _aRxLevel[BSP_UART_RX_LEVEL]);
+  UART_EnableInt(pUnit->pUART, UART_INT_RX | UART_INT_RT | RX_ERR_INTS);
+  if (pUnit->IsTxActive != 0u) {
+    UART_EnableInt(pUnit->pUART, UART_INT_TX);
   }
-  UART_ClearInt(BSP_UART, UART_INT_ALL);
 }
 
-void BSP_UART_DeInit(unsigned int Unit)
-{
-  PERIPHERAL_DISABLE_(UART, OS_UART);
+/*********************************************************************
+*
+*       _FillTxFifoSG()
+*
+*  Function description
+*    Moves data of the active BSP_UART_WriteV() segments into the
+*    hardware FIFO until the FIFO is full or all segments were sent.
+*
+*  Return value
+*    == 0: FIFO is full.
+*    != 0: All segments were sent, the completion event was set.
+*/
+static int _FillTxFifoSG(UART_UNIT* pUnit) {
+  const OS_U8* pData;
+  unsigned int NumRem;
+
+  pData  = pUnit->pSGData;
+  NumRem = pUnit->SGNumRem;
+  for (;;) {
+    while ((NumRem != 0u) && (UART_IsTxFifoFull(pUnit->pUART) == 0)) {
+      UART_TransmitData(pUnit->pUART, *pData);
+      pData++;
+      NumRem--;
+      pUnit->Stat.NumTxBytes++;
+    }
+    if (NumRem != 0u) {
+      pUnit->pSGData  = pData;
+      pUnit->SGNumRem = NumRem;
+      return 0;
+    }
+    if (--pUnit->NumSG == 0u) {
+      pUnit->paSG = NULL;
+      if (pUnit->pSGEvent != NULL) {
+        OS_EVENT_Set(pUnit->pSGEvent);
+      }
+      return 1;
+    }
+    pUnit->paSG++;
+    pData  = (const OS_U8*)pUnit->paSG->pSrc;
+    NumRem = pUnit->paSG->Size;
+  }
 }
 
-void BSP_UART_Init(unsigned int Unit, unsigned long Baudrate, unsigned char NumDataBits, unsigned char Parity, unsigned char NumStopBits)
-{
-  PERIPHERAL_ENABLE_(UART, OS_UART);
-  UART_Init(BSP_UART, Baudrate, UART_LCR_DATABITS_8, UART_LCR_STOPBITS_1,
-            Parity == BSP_UART_PARITY_NONE ? UART_LCR_PARITY_NONE : Parity == BSP_UART_PARITY_EVEN ? UART_LCR_PARITY_EVEN : UART_LCR_PARITY_ODD,
-            UART_LCR_FIFO_1);
-  UART_EnableInt(BSP_UART, UART_INT_RX | UART_INT_TX);
-  INT_EnableIRQ(UARTx_IRQn(OS_UART), PLIC_MAX_PRIORITY);
+/*********************************************************************
+*
+*       _FillTxFifo()
+*
+*  Function description
+*    Moves data from the TX ring and the active BSP_UART_WriteV()
+*    segments into the hardware FIFO until the FIFO is full or no data
+*    remains.
+*
+*  Return value
+*    == 0: All data was passed to the FIFO.
+*    != 0: Data remains.
+*
+*  Additional information
+*    Must be called with interrupts disabled or from the TX interrupt.
+*/
+static unsigned int _FillTxFifo(UART_UNIT* pUnit) {
+  unsigned int RdPos;
+  unsigned int EndPos;
+
+  do {
+    RdPos  = pUnit->TxRdPos;
+    EndPos = (pUnit->paSG != NULL) ? pUnit->SGPos : pUnit->TxWrPos;  // Data queued after the segments waits for them
+    while ((RdPos != EndPos) && (UART_IsTxFifoFull(pUnit->pUART) == 0)) {
+      UART_TransmitData(pUnit->pUART, pUnit->aTxBuffer[RdPos & TX_BUFFER_MASK]);
+      RdPos++;
+    }
+    pUnit->Stat.NumTxBytes += RdPos - pUnit->TxRdPos;
+    pUnit->TxRdPos          = RdPos;
+  } while ((RdPos == EndPos) && (pUnit->paSG != NULL) && (_FillTxFifoSG(pUnit) != 0));
+  return (pUnit->TxWrPos - RdPos) + ((pUnit->paSG != NULL) ? 1u : 0u);
 }
 
-void BSP_UART_Write1(unsigned int Unit, unsigned char Data)
-{
-  UART_TransmitData(BSP_UART, Data);
+/*********************************************************************
+*
+*       _OnTx()
+*
+*  Function description
+*    Handles the TX interrupt.
+*
+*  Additional information
+*    Once the ring is empty, the write callback is called repeatedly
+*    to queue more data, as long as the hardware FIFO has room. A
+*    callback which queues one byte per call, like the one of
+*    embOSView, therefore fills the whole FIFO per interrupt. If it has
+*    nothing to send, the TX interrupt is disabled until the next call
+*    of BSP_UART_Write().
+*/
+static void _OnTx(UART_UNIT* pUnit) {
+  unsigned int WrPos;
+
+  pUnit->Stat.NumTxInts++;
+  while (_FillTxFifo(pUnit) == 0u) {  // Ring is empty and the FIFO may have room
+    WrPos = pUnit->TxWrPos;
+    if ((pUnit->pfOnTx == NULL) || (pUnit->pfOnTx(pUnit->Unit) != 0) || (pUnit->TxWrPos == WrPos)) {
+      UART_DisableInt(pUnit->pUART, UART_INT_TX);
+      pUnit->IsTxActive = 0u;
+      break;
+    }
+  }
+}
+
+/*********************************************************************
+*
+*       _OnRx()
+*
+*  Function description
+*    Handles the RX, receive timeout and RX error interrupts.
+*
+*  Additional information
+*    Errors are counted once per interrupt. Received bytes are passed
+*    to the read callback, or stored in the RX ring if none is set.
+*    Bytes which do not fit into the RX ring are dropped and counted.
+*/
+static void _OnRx(UART_UNIT* pUnit) {
+  UART_TypeDef*   pUART;
+  BSP_UART_RX_CB* pfOnRx;
+  unsigned int    WrPos;
+  unsigned char   Data;
+
+  pUART = pUnit->pUART;
+  if (UART_IsMaskedIntActive(pUART, RX_ERR_INTS)) {
+    if (UART_IsRawIntActive(pUART, UART_INT_OE)) {
+      pUnit->Stat.NumOverrunErrors++;
+    }
+    if (UART_IsRawIntActive(pUART, UART_INT_FE)) {
+      pUnit->Stat.NumFramingErrors++;
+    }
+    if (UART_IsRawIntActive(pUART, UART_INT_PE)) {
+      pUnit->Stat.NumParityErrors++;
+    }
+    if (UART_IsRawIntActive(pUART, UART_INT_BE)) {
+      pUnit->Stat.NumBreaks++;
+    }
+  }
+  pfOnRx = pUnit->pfOnRx;
+  if (pfOnRx != NULL) {
+    while (UART_IsRxFifoEmpty(pUART) == 0) {
+      pfOnRx(pUnit->Unit, UART_ReceiveData(pUART));
+      pUnit->Stat.NumRxBytes++;
+    }
+  } else {
+    WrPos = pUnit->RxWrPos;
+    while (UART_IsRxFifoEmpty(pUART) == 0) {
+      Data = UART_ReceiveData(pUART);
+      pUnit->Stat.NumRxBytes++;
+      if ((WrPos - pUnit->RxRdPos) < BSP_UART_RX_BUFFER_SIZE) {
+        pUnit->aRxBuffer[WrPos & RX_BUFFER_MASK] = Data;
+        WrPos++;
+      } else {
+        pUnit->Stat.NumRxDropped++;
+      }
+    }
+    pUnit->RxWrPos = WrPos;
+  }
+}
+
+/*********************************************************************
+*
+*       _OnIRQ()
+*
+*  Function description
+*    UART interrupt handler, called from ISR_M_External() with the unit
+*    as context.
+*
+*  Additional information
+*    With the FIFOs enabled, the RX interrupt is raised at the FIFO
+*    trigger level and the receive timeout interrupt for the bytes
+*    below. Both drain all received bytes.
+*/
+static void _OnIRQ(void* pContext) {
+  UART_UNIT* pUnit;
+
+  pUnit = (UART_UNIT*)pContext;
+  if (UART_IsMaskedIntActive(pUnit->pUART, UART_INT_RX | UART_INT_RT | RX_ERR_INTS)) {
+    _OnRx(pUnit);
+  }
+  if (UART_IsMaskedIntActive(pUnit->pUART, UART_INT_TX)) {
+    _OnTx(pUnit);
+  }
+  UART_ClearInt(pUnit->pUART, UART_INT_ALL);
+}
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+#if (EXTEND_GLOBAL_ISR_CONTEXT == 0)
+/*********************************************************************
+*
+*       UART0_isr() ... UART4_isr()
+*
+*  Function description
+*    UART interrupt handlers, as referenced by the interrupt handler
+*    tables. Only used if the handler cannot be installed with its
+*    context via BSP_PLIC_InstallISR_Ex().
+*
+*  Additional information
+*    Only the handlers of the units selected by BSP_UART_ISR_UNITS are
+*    defined.
+*/
+#if ((BSP_UART_ISR_UNITS & (1u << 0)) != 0u)
+DEFINE_ISR(0)
+#endif
+#if ((BSP_UART_ISR_UNITS & (1u << 1)) != 0u)
+DEFINE_ISR(1)
+#endif
+#if ((BSP_UART_ISR_UNITS & (1u << 2)) != 0u)
+DEFINE_ISR(2)
+#endif
+#if ((BSP_UART_ISR_UNITS & (1u << 3)) != 0u)
+DEFINE_ISR(3)
+#endif
+#if ((BSP_UART_ISR_UNITS & (1u << 4)) != 0u)
+DEFINE_ISR(4)
+#endif
+#endif
+
+/*********************************************************************
+*
+*       BSP_UART_DeInit()
+*/
+void BSP_UART_DeInit(unsigned int Unit) {
+  UART_UNIT* pUnit;
+
+  if (Unit >= BSP_UART_NUM_UNITS) {
+    return;
+  }
+  pUnit = &_aUnit[Unit];
+  INT_DisableIRQ((int)pUnit->IRQIndex);
+  OS_INT_IncDI();
+  UART_DisableInt(pUnit->pUART, UART_INT_ALL);
+  pUnit->IsTxActive = 0u;
+  pUnit->paSG       = NULL;  // Pending segments are discarded without setting their event
+  OS_INT_DecRI();
+  _SetClock(Unit, 0u);
 }
+
+/*********************************************************************
+*
+*       BSP_UART_Init()
+*
+*  Additional information
+*    Enables the 16 byte FIFOs. The TX interrupt is raised when the TX
+*    FIFO drains to 1/8 and is enabled only while data is queued. The
+*    RX interrupt is raised at BSP_UART_RX_LEVEL. Callbacks set before
+*    are kept.
+*/
+void BSP_UART_Init(unsigned int Unit, unsigned long Baudrate, unsigned char NumDataBits, unsigned char Parity, unsigned char NumStopBits) {
+  UART_UNIT* pUnit;
+
+  BSP_UART_USE_PARA(NumDataBits);
+  BSP_UART_USE_PARA(NumStopBits);
+  if (Unit >= BSP_UART_NUM_UNITS) {
+    return;
+  }
+  pUnit = &_aUnit[Unit];
+  OS_INT_IncDI();
+  _GetHW(pUnit, Unit);
+  pUnit->Baudrate   = Baudrate;
+  pUnit->Parity     = Parity;
+  pUnit->IsTxActive = 0u;
+  pUnit->TxWrPos    = 0u;
+  pUnit->TxRdPos    = 0u;
+  pUnit->RxWrPos    = 0u;
+  pUnit->RxRdPos    = 0u;
+  pUnit->paSG       = NULL;
+  OS_INT_DecRI();
+  _SetClock(Unit, 1u);
+  _ConfigHW(pUnit);
+#if (EXTEND_GLOBAL_ISR_CONTEXT != 0)
+  (void)BSP_PLIC_InstallISR_Ex(pUnit->IRQIndex, _OnIRQ, pUnit);
+#endif
+  INT_EnableIRQ((int)pUnit->IRQIndex, BSP_PLIC_EMBOS_MAX_PRIORITY);  // Calls embOS API, must not use the zero-latency priority
+}
+
+/*********************************************************************
+*
+*       BSP_UART_SetBaudrate()
+*
+*  Function description
+*    Changes the baudrate of an initialized unit.
+*
+*  Additional information
+*    Data in the hardware FIFOs may be corrupted, hence this should be
+*    called while the unit is idle. Data queued in the rings is kept.
+*/
+void BSP_UART_SetBaudrate(unsigned int Unit, unsigned long Baudrate) {
+  UART_UNIT* pUnit;
+
+  if (Unit >= BSP_UART_NUM_UNITS) {
+    return;
+  }
+  pUnit = &_aUnit[Unit];
+  OS_INT_IncDI();
+  pUnit->Baudrate = Baudrate;
+  _ConfigHW(pUnit);
+  OS_INT_DecRI();
+}
+
+/*********************************************************************
+*
+*       BSP_UART_SetReadCallback()
+*
+*  Function description
+*    Sets the routine which receives each byte in the RX interrupt.
+*
+*  Parameters
+*    Unit: UART unit.
+*    pf:   Routine called from the RX interrupt. NULL stores received
+*          bytes in the RX ring, see BSP_UART_Read().
+*/
+void BSP_UART_SetReadCallback(unsigned int Unit, BSP_UART_RX_CB* pf) {
+  if (Unit < BSP_UART_NUM_UNITS) {
+    _aUnit[Unit].pfOnRx = pf;
+  }
+}
+
+/*********************************************************************
+*
+*       BSP_UART_SetWriteCallback()
+*
+*  Function description
+*    Sets the routine which the TX interrupt calls once the TX ring is
+*    empty.
+*
+*  Parameters
+*    Unit: UART unit.
+*    pf:   Routine called from the TX interrupt. It may queue more data
+*          via BSP_UART_Write() and returns 0 if it did so, else != 0.
+*/
+void BSP_UART_SetWriteCallback(unsigned int Unit, BSP_UART_TX_CB* pf) {
+  if (Unit < BSP_UART_NUM_UNITS) {
+    _aUnit[Unit].pfOnTx = pf;
+  }
+}
+
+/*********************************************************************
+*
+*       BSP_UART_Write()
+*
+*  Function description
+*    Queues data for transmission.
+*
+*  Parameters
+*    Unit:     UART unit.
+*    pData:    Data to send.
+*    NumBytes: Number of bytes to send.
+*
+*  Return value
+*    Number of bytes queued. Less than NumBytes if the TX ring is full.
+*
+*  Additional information
+*    Does not block and may be called from tasks and interrupts. If the
+*    transmitter is idle, the hardware FIFO is filled right away and
+*    the TX interrupt is enabled.
+*/
+unsigned int BSP_UART_Write(unsigned int Unit, const unsigned char* pData, unsigned int NumBytes) {
+  UART_UNIT*   pUnit;
+  unsigned int NumFree;
+  unsigned int i;
+
+  if (Unit >= BSP_UART_NUM_UNITS) {
+    return 0u;
+  }
+  pUnit = &_aUnit[Unit];
+  OS_INT_IncDI();
+  NumFree = BSP_UART_TX_BUFFER_SIZE - (pUnit->TxWrPos - pUnit->TxRdPos);
+  if (NumBytes > NumFree) {
+    NumBytes = NumFree;
+  }
+  for (i = 0u; i < NumBytes; i++) {
+    pUnit->aTxBuffer[(pUnit->TxWrPos + i) & TX_BUFFER_MASK] = pData[i];
+  }
+  pUnit->TxWrPos += NumBytes;
+  if ((pUnit->IsTxActive == 0u) && (NumBytes != 0u)) {
+    pUnit->IsTxActive = 1u;
+    (void)_FillTxFifo(pUnit);
+    UART_EnableInt(pUnit->pUART, UART_INT_TX);
+  }
+  OS_INT_DecRI();
+  return NumBytes;
+}
+
+/*********************************************************************
+*
+*       BSP_UART_WriteV()
+*
+*  Function description
+*    Transmits a list of segments without copying them.
+*
+*  Parameters
+*    Unit:     UART unit.
+*    paSrc:    List of segments, e.g. header, payload and checksum.
+*    NumSrc:   Number of segments.
+*    pEvent:   Event object which is set from the TX interrupt once all
+*              segments were passed to the hardware FIFO. May be NULL.
+*
+*  Return value
+*    == 0: O.K., transmission started or queued.
+*    != 0: Error, invalid parameter or another list is still active.
+*
+*  Additional information
+*    The list and the segments must not be modified until pEvent was
+*    set. One list may be active per unit. It is sent after the data
+*    queued via BSP_UART_Write() before this call, data queued later
+*    is sent after the list. May be called from tasks and interrupts.
+*/
+int BSP_UART_WriteV(unsigned int Unit, const OS_QUEUE_SRCLIST* paSrc, unsigned int NumSrc, OS_EVENT* pEvent) {
+  UART_UNIT* pUnit;
+
+  if ((Unit >= BSP_UART_NUM_UNITS) || (NumSrc == 0u)) {
+    return -1;
+  }
+  pUnit = &_aUnit[Unit];
+  OS_INT_IncDI();
+  if (pUnit->paSG != NULL) {
+    OS_INT_DecRI();
+    return -1;
+  }
+  pUnit->paSG     = paSrc;
+  pUnit->NumSG    = NumSrc;
+  pUnit->pSGData  = (const OS_U8*)paSrc->pSrc;
+  pUnit->SGNumRem = paSrc->Size;
+  pUnit->SGPos    = pUnit->TxWrPos;
+  pUnit->pSGEvent = pEvent;
+  if (pUnit->IsTxActive == 0u) {
+    pUnit->IsTxActive = 1u;
+    (void)_FillTxFifo(pUnit);
+    UART_EnableInt(pUnit->pUART, UART_INT_TX);
+  }
+  OS_INT_DecRI();
+  return 0;
+}
+
+/*********************************************************************
+*
+*       BSP_UART_Write1()
+*
+*  Function description
+*    Queues a single byte for transmission, see BSP_UART_Write().
+*/
+void BSP_UART_Write1(unsigned int Unit, unsigned char Data) {
+  (void)BSP_UART_Write(Unit, &Data, 1u);
+}
+
+/*********************************************************************
+*
+*       BSP_UART_Read()
+*
+*  Function description
+*    Reads received data from the RX ring.
+*
+*  Parameters
+*    Unit:     UART unit.
+*    pData:    Buffer which receives the data.
+*    NumBytes: Size of the buffer in bytes.
+*
+*  Return value
+*    Number of bytes read, 0 if no data was received.
+*
+*  Additional information
+*    Does not block. While a read callback is set, received bytes are
+*    passed to it and none are returned here.
+*/
+unsigned int BSP_UART_Read(unsigned int Unit, unsigned char* pData, unsigned int NumBytes) {
+  UART_UNIT*   pUnit;
+  unsigned int NumAvail;
+  unsigned int i;
+
+  if (Unit >= BSP_UART_NUM_UNITS) {
+    return 0u;
+  }
+  pUnit = &_aUnit[Unit];
+  OS_INT_IncDI();
+  NumAvail = pUnit->RxWrPos - pUnit->RxRdPos;
+  if (NumBytes > NumAvail) {
+    NumBytes = NumAvail;
+  }
+  for (i = 0u; i < NumBytes; i++) {
+    pData[i] = pUnit->aRxBuffer[(pUnit->RxRdPos + i) & RX_BUFFER_MASK];
+  }
+  pUnit->RxRdPos += NumBytes;
+  OS_INT_DecRI();
+  return NumBytes;
+}
+
+/*********************************************************************
+*
+*       BSP_UART_GetStat()
+*
+*  Function description
+*    Returns a consistent copy of the statistics of a unit.
+*
+*  Additional information
+*    NumTxBytes / NumTxInts is the average number of bytes sent per TX
+*    interrupt, e.g. to compare the load caused by embOSView.
+*/
+void BSP_UART_GetStat(unsigned int Unit, BSP_UART_STAT* pStat) {
+  if (Unit >= BSP_UART_NUM_UNITS) {
+    return;
+  }
+  OS_INT_IncDI();
+  *pStat = _aUnit[Unit].Stat;
+  OS_INT_DecRI();
+}
+
+/*********************************************************************
+*
+*       BSP_UART_ResetStat()
+*/
+void BSP_UART_ResetStat(unsigned int Unit) {
+  BSP_UART_STAT* pStat;
+
+  if (Unit >= BSP_UART_NUM_UNITS) {
+    return;
+  }
+  pStat = &_aUnit[Unit].Stat;
+  OS_INT_IncDI();
+  pStat->NumTxBytes       = 0u;
+  pStat->NumTxInts        = 0u;
+  pStat->NumRxBytes       = 0u;
+  pStat->NumRxDropped     = 0u;
+  pStat->NumOverrunErrors = 0u;
+  pStat->NumFramingErrors = 0u;
+  pStat->NumParityErrors  = 0u;
+  pStat->NumBreaks        = 0u;
+  OS_INT_DecRI();
+}
+
+/*************************** End of file ****************************/
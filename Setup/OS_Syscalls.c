@@ -38,6 +38,7 @@ Purpose : Newlib Syscalls callback functions.
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/times.h>
+#include "BSP_Log.h"
 
 /*********************************************************************
 *
@@ -377,8 +378,14 @@ int _wait(int* pStatus) {
 *    (not shown; typically, you must write this in assembler from examples provided by your hardware manufacturer)
 *    to actually perform the output.
 *    Not needed (supported) by embOS, minimal implementation
+*    With DEFERRED_LOG enabled, the output of all files is queued to the
+*    log ring, see BSP_Log.c.
 */
 int _write(int file, char* p, int len) {
+#if (DEFERRED_LOG != 0)
+  (void) file;  /* Not used, avoid warning */
+  return BSP_LOG_Write(p, len);
+#else
   int todo;
 
   (void) file;  /* Not used, avoid warning */
@@ -388,6 +395,7 @@ int _write(int file, char* p, int len) {
     /* outbyte (*p++); */ /* Not supported, has to be implemented if needed */
   }
   return len;
+#endif
 }
 
 /*************************** End of file ****************************/
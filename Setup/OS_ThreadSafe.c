@@ -35,12 +35,16 @@ Additional information:
   embOS interrupts. Zero latency interrupts are not affected and protected.
   If you need to call e.g. malloc() also from within a zero latency interrupt
   additional handling needs to be added.
+  With ZERO_LATENCY_TIER enabled, the interrupt safe lock disables only
+  the embOS interrupt tier via BSP_INT_DisableEmbOS(), hence zero latency
+  interrupts are not delayed by heap operations.
   If you don't call such functions from within embOS interrupts you can use
   thread safety instead. This reduces the interrupt latency because a mutex
   is used instead of disabling embOS interrupts.
 */
 
 #include "RTOS.h"
+#include "RTOSInit.h"
 
 /*********************************************************************
 *
@@ -88,7 +92,9 @@ void __malloc_unlock(struct _reent *_r) OS_TEXT_SECTION_ATTRIBUTE(__malloc_unloc
 */
 void __malloc_lock(struct _reent *_r) {
   OS_USE_PARA(_r);
-#if (OS_INTERRUPT_SAFE == 1)
+#if ((OS_INTERRUPT_SAFE == 1) && (ZERO_LATENCY_TIER != 0))
+  BSP_INT_DisableEmbOS();
+#elif (OS_INTERRUPT_SAFE == 1)
   OS_InterruptSafe_Lock();
 #else
   OS_ThreadSafe_Lock();
@@ -101,7 +107,9 @@ void __malloc_lock(struct _reent *_r) {
 */
 void __malloc_unlock(struct _reent *_r) {
   OS_USE_PARA(_r);
-#if (OS_INTERRUPT_SAFE == 1)
+#if ((OS_INTERRUPT_SAFE == 1) && (ZERO_LATENCY_TIER != 0))
+  BSP_INT_EnableEmbOS();
+#elif (OS_INTERRUPT_SAFE == 1)
   OS_InterruptSafe_Unlock();
 #else
   OS_ThreadSafe_Unlock();
@@ -30,12 +30,30 @@ Purpose : Initializes and handles the hardware for embOS
 */
 
 #include "RTOS.h"
+#include "RTOSInit.h"
 #include "BSP_UART.h"
+#include "BSP_Timestamp.h"
+#if (DEADLINE_SERVICE != 0)
+  #include "BSP_Deadline.h"
+#endif
+#if (TIMER_WHEEL != 0)
+  #include "BSP_TimerWheel.h"
+#endif
+#if (IRQ_STORM_DETECTION != 0)
+  #include "BSP_IRQStorm.h"
+#endif
+#if (DEFERRED_LOG != 0)
+  #include "BSP_Log.h"
+#endif
 #include "interrupt.h"
 #include "board.h"
 
 extern uint32_t __stack_pointer$;
 extern uint32_t __stack_start;
+#if (INT_STACK != 0)
+extern OS_U32 __stack_start__[];  // System stack, used as interrupt stack, see linker.ld
+extern OS_U32 __stack_end__[];
+#endif
 
 /*********************************************************************
 *
@@ -44,20 +62,12 @@ extern uint32_t __stack_start;
 **********************************************************************
 */
 
-/*********************************************************************
-*
-*       Interrupt handling configuration
-*/
-#ifndef   EXTEND_GLOBAL_ISR_CONTEXT
-  #define EXTEND_GLOBAL_ISR_CONTEXT  (1)  // Allows to pass a context to global ISRs
-#endif
-
 /*********************************************************************
 *
 *       System tick settings
 */
 #define OS_TIMER_FREQ (BOARD_PLL_FREQUENCY)
-#define OS_TICK_FREQ  (1000u)
+#define OS_TICK_FREQ  (1000u)            // Default, may be changed at runtime via BSP_TICK_SetFreq()
 #define OS_INT_FREQ   (OS_TICK_FREQ)
 
 #define OS_TIMER_RELOAD  (OS_TIMER_FREQ / OS_INT_FREQ)
@@ -75,19 +85,106 @@ extern uint32_t __stack_start;
 *       Device specific SFRs
 */
 //
-//  Machine timer registers
+//  Machine timer registers, see BSP_Timestamp.h
 //
-#define MTIME                 (*(volatile OS_U64*)(0x200BFF8u))  // Used to generate OS tick, Timer counter register
-#define MTIMECMP              (*(volatile OS_U64*)(0x2004000u))  // Used to generate OS tick, Timer compare register
+#define MTIME                 (BSP_TS_GetMTime())                // Used to generate OS tick, Timer counter register (tear-free read)
 //
 // Core-local interrupts
 //
 #define NUM_LOCAL_INTERRUPTS  (16 + LOCAL_INT_COUNT)
+
+#if ((CLINT_VECTORED_MODE != 0) && (NUM_LOCAL_INTERRUPTS > 32))
+  #error "vtrap_entry.S provides 32 vector entries, LOCAL_INT_COUNT must not exceed 16"
+#endif
 //
 //  Programmable interrupt controller
 //
 #define PLIC_BASE_ADDR         (PLIC_BASE)
 #define PLIC_NUM_INTERRUPTS    (PLIC_TOTAL_INTERRUPT_COUNT)
+#define PLIC_PRIORITY(IRQIndex) (*(volatile OS_U32*)(PLIC_BASE_ADDR + ((IRQIndex) * 4u)))
+#define PLIC_THRESHOLD          (*(volatile OS_U32*)(PLIC_BASE_ADDR + 0x200000u))  // Priority threshold of the hart 0 context
+#define PLIC_CLAIM              (*(volatile OS_U32*)(PLIC_BASE_ADDR + 0x200004u))  // Claim/complete register of the hart 0 context
+//
+//  Core-local interrupts of the embOS tier, masked by BSP_INT_DisableEmbOS()
+//
+#define MIE_EMBOS_MASK         ((1u << IRQ_M_TIMER) | (1u << IRQ_M_SOFTWARE))
+
+/*********************************************************************
+*
+*       Global IRQ claim
+*
+*  With ZERO_LATENCY_TIER enabled, global IRQs are claimed before it is
+*  known whether OS_INT_Enter() is called. The claim register is then
+*  accessed directly, since OS_PLIC_ClaimInt() of the debug libraries
+*  requires OS_INT_Enter() to be called before.
+*/
+#if (ZERO_LATENCY_TIER != 0)
+  #define CLAIM_INT()            (PLIC_CLAIM)
+  #define COMPLETE_INT(IRQIndex) (PLIC_CLAIM = (IRQIndex))
+#else
+  #define CLAIM_INT()            OS_PLIC_ClaimInt()
+  #define COMPLETE_INT(IRQIndex) OS_PLIC_CompleteInt(IRQIndex)
+#endif
+
+/*********************************************************************
+*
+*       Interrupt stack
+*
+*  With INT_STACK enabled, the interrupt routines run on the system
+*  stack (.stack in linker.ld) instead of the stack of the interrupted
+*  task. The unused part of it is filled by OS_InitHW() to measure its
+*  high-water mark.
+*/
+#define INT_STACK_FILL         (0xCDCDCDCDu)
+#define INT_STACK_MARGIN       (64u)  // Bytes below the stack pointer of OS_InitHW() which are not filled
+
+#if (INT_STACK != 0)
+  #define CALL_INT_ROUTINE(pfRoutine, p)  _CallOnIntStack((pfRoutine), (p))
+#else
+  #define CALL_INT_ROUTINE(pfRoutine, p)  (pfRoutine)(p)
+#endif
+
+/*********************************************************************
+*
+*       Interrupt handler tables
+*
+*  With ISR_TABLE_CONST enabled, the handlers are read from the const
+*  tables _apCLINT_ISR[] and _apPLIC_ISR[] instead of the RAM tables of
+*  the device support package.
+*/
+#if (ISR_TABLE_CONST != 0)
+  #define CLINT_ISR(IRQIndex)    (_apCLINT_ISR[IRQIndex])
+  #define PLIC_ISR(IRQIndex)     (_apPLIC_ISR[IRQIndex])
+#else
+  #define CLINT_ISR(IRQIndex)    (clint_isr[IRQIndex])
+  #define PLIC_ISR(IRQIndex)     (plic_isr[IRQIndex])
+#endif
+
+#if (OS_VIEW_IFSELECT == OS_VIEW_IF_UART) && (EXTEND_GLOBAL_ISR_CONTEXT == 0)
+  #define UART_ISR_ENTRY         [UARTx_IRQn(OS_UART)] = BSP_UART_IRQHandler(OS_UART),
+#else
+  #define UART_ISR_ENTRY
+#endif
+
+/*********************************************************************
+*
+*       Global IRQ entry
+*
+*  With PLIC_NESTABLE enabled, ISR_M_External() enters embOS as nestable
+*  interrupt. Interrupts are disabled again right away and enabled per
+*  handler, once the PLIC threshold has been raised to its priority.
+*  OS_INT_EnterNestable() enables interrupts before the threshold can be
+*  raised, hence _ServePLIC() masks the machine external interrupt in
+*  mie until then. Only the core-local interrupts may nest in between,
+*  which preempt any global IRQ handler anyway.
+*/
+#if (PLIC_NESTABLE != 0)
+  #define ENTER_INT()            { OS_INT_EnterNestable(); OS_INT_Disable(); }
+  #define LEAVE_INT()            OS_INT_LeaveNestable()
+#else
+  #define ENTER_INT()            OS_INT_Enter()
+  #define LEAVE_INT()            OS_INT_Leave()
+#endif
 /*********************************************************************
 *
 *       Function prototypes
@@ -97,6 +194,17 @@ extern uint32_t __stack_start;
 void ISR_M_Software(void);
 void ISR_M_Timer   (void);
 void ISR_M_External(void);
+#if (ISR_TABLE_CONST != 0)
+static void _ISR_NotInstalled(void);
+#endif
+
+/*********************************************************************
+*
+*       Types, local
+*
+**********************************************************************
+*/
+typedef void INT_ROUTINE(void* p);
 
 /*********************************************************************
 *
@@ -104,6 +212,70 @@ void ISR_M_External(void);
 *
 **********************************************************************
 */
+static OS_U32  _TimerReload = OS_TIMER_RELOAD;  // Timer cycles per tick interrupt
+static OS_BOOL _IsFractionalTick;               // Set when the tick frequency differs from the interrupt frequency
+static OS_U64  _TickCompare;                    // Timer value of the next tick interrupt
+static BSP_BOOT_STAT _BootStat;                 // CPU cycles up to and within OS_InitHW()
+#if (DEADLINE_SERVICE != 0)
+static OS_U64  _DeadlineCompare = BSP_MTIMER_NO_DEADLINE;  // Timer value of the earliest pending deadline
+#endif
+#if (TICKLESS_IDLE != 0)
+static OS_U64 _TicklessBase;     // Compare value of the first tick boundary within the current tickless period
+static OS_U32 _NumSkippedTicks;  // Number of ticks which were not handled by the timer interrupt
+#endif
+#if (TICK_CATCHUP_BULK != 0)
+static OS_U32 _NumCoalescedTicks;  // Number of missed ticks which were accounted for in bulk
+#endif
+#if (TICK_STATISTICS != 0)
+static BSP_TICK_STAT _TickStat;    // Tick interrupt lateness and duration
+#endif
+#if (PLIC_DRAIN_STATISTICS != 0)
+static BSP_PLIC_DRAIN_STAT _DrainStat;  // Global IRQs served per ISR_M_External() entry
+#endif
+#if (PLIC_NESTABLE != 0)
+static BSP_PLIC_NEST_STAT  _NestStat;   // Nesting depth and priority order of global IRQ handlers
+static OS_U32              _NestDepth;  // Number of global IRQ handlers currently running
+#endif
+#if (IRQ_STATISTICS != 0)
+static BSP_IRQ_STAT _aCLINTStat[NUM_LOCAL_INTERRUPTS];  // Latency and duration per core-local interrupt
+static BSP_IRQ_STAT _aPLICStat[PLIC_NUM_INTERRUPTS];    // Latency and duration per global interrupt
+static OS_U32       _IRQEntry;                           // CPU cycles at OS_TrapHandler() entry, latency base of both tables
+#endif
+#if (IRQ_COUNTERS != 0)
+static OS_U32 _aCLINTCnt[NUM_LOCAL_INTERRUPTS];  // Calls per core-local interrupt
+static OS_U32 _aPLICCnt[PLIC_NUM_INTERRUPTS];    // Claims per global interrupt
+static OS_U32 _NumSpurious;                      // ISR_M_External() entries without a pending IRQ
+static OS_U32 _NumNotInstalled;                  // Calls of _ISR_NotInstalled() and _ISR_NotInstalled_Ex()
+static OS_U32 _ActiveIRQ;                        // Source being served: CLINT cause, or NUM_LOCAL_INTERRUPTS + global IRQ index
+static OS_U64 _CntResetTime;                     // OS_TIME_Get_us64() at BSP_IRQ_ResetCounts()
+#endif
+#if (EXTEND_GLOBAL_ISR_CONTEXT != 0)
+static OS_IRQ_HANDLER_CONTEXT _aPLIC_ISR_Ex[PLIC_NUM_INTERRUPTS];  // Dispatch table of global ISRs, see BSP_PLIC_InstallISR_Ex()
+#endif
+#if (ZERO_LATENCY_TIER != 0)
+static OS_U8  _aIsZeroLatency[PLIC_NUM_INTERRUPTS];  // Global IRQs served without OS_INT_Enter(), see BSP_PLIC_SetZeroLatency()
+static OS_U8  _aIsDeferred[PLIC_NUM_INTERRUPTS];     // Claimed embOS-tier IRQs which are served by ISR_M_Software()
+static OS_U32 _EmbOSDisableCnt;                      // Nesting counter of BSP_INT_DisableEmbOS()
+static OS_U32 _EmbOSThreshold;                       // PLIC threshold before BSP_INT_DisableEmbOS()
+static OS_U32 _EmbOSMIE;                             // mie bits cleared by BSP_INT_DisableEmbOS()
+#endif
+#if (ISR_TABLE_CONST != 0)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Woverride-init"     // Specific handlers override the range default
+static OS_IRQ_HANDLER* const _apCLINT_ISR[NUM_LOCAL_INTERRUPTS] = {
+  [0 ... (NUM_LOCAL_INTERRUPTS - 1)] = _ISR_NotInstalled,
+  [IRQ_M_SOFTWARE]                   = ISR_M_Software,
+  [IRQ_M_TIMER]                      = ISR_M_Timer,
+  [IRQ_M_EXTERNAL]                   = ISR_M_External,
+  BSP_CLINT_ISR_TABLE
+};
+static OS_IRQ_HANDLER* const _apPLIC_ISR[PLIC_NUM_INTERRUPTS] = {
+  [0 ... (PLIC_NUM_INTERRUPTS - 1)]  = _ISR_NotInstalled,
+  UART_ISR_ENTRY
+  BSP_PLIC_ISR_TABLE
+};
+#pragma GCC diagnostic pop
+#endif
 
 /*********************************************************************
 *
@@ -128,11 +300,11 @@ static unsigned int _OS_GetHWTimerCycles(void) {
   OS_U64       Counter;
   OS_U64       Compare;
 
-  Compare = MTIMECMP;
+  Compare = _TickCompare;
   Counter = MTIME;
   Diff    = (OS_I64)(Counter - Compare);
   if (Diff < 0) {
-    Result = (unsigned int)(OS_TIMER_RELOAD + Diff);
+    Result = (unsigned int)(_TimerReload + Diff);
   } else {
     Result = (unsigned int)(Diff);
   }
@@ -149,10 +321,206 @@ static unsigned int _OS_GetHWTimerCycles(void) {
 *  Return value
 *    == 0: Interrupt pending flag not set.
 *    != 0: Interrupt pending flag set.
+*
+*  Additional information
+*    The machine timer interrupt may also be pending for a deadline,
+*    hence the pending tick is derived from the tick compare value.
 */
 static unsigned int _OS_GetHWTimer_IntPending(void) {
-  return ((unsigned int)OS_CLINT_GetIntPending(IRQ_M_TIMER));
+  return (MTIME >= _TickCompare) ? 1u : 0u;
+}
+
+/*********************************************************************
+*
+*       _UpdateCompare()
+*
+*  Function description
+*    Programs the machine timer compare register with the earliest of
+*    the next tick and the next deadline.
+*
+*  Additional information
+*    Must be called with interrupts disabled.
+*/
+static void _UpdateCompare(void) {
+#if (DEADLINE_SERVICE != 0)
+  BSP_TS_SetMTimeCmp((_DeadlineCompare < _TickCompare) ? _DeadlineCompare : _TickCompare);
+#else
+  BSP_TS_SetMTimeCmp(_TickCompare);
+#endif
+}
+
+#if ((TICK_STATISTICS != 0) || (IRQ_STATISTICS != 0))
+/*********************************************************************
+*
+*       _GetBucket()
+*
+*  Function description
+*    Returns the log2 histogram bucket of a value.
+*
+*  Additional information
+*    Bucket 0 counts samples of value 0, bucket n counts samples in the
+*    range [2^(n-1), 2^n). The last bucket also counts all larger ones.
+*/
+static OS_U32 _GetBucket(OS_U32 Value, OS_U32 NumBuckets) {
+  OS_U32 Index;
+
+  Index = (Value != 0u) ? (32u - (OS_U32)__builtin_clz(Value)) : 0u;
+  if (Index >= NumBuckets) {
+    Index = NumBuckets - 1u;
+  }
+  return Index;
+}
+#endif
+
+#if (TICK_STATISTICS != 0)
+/*********************************************************************
+*
+*       _ResetHistogram()
+*/
+static void _ResetHistogram(BSP_TICK_HISTOGRAM* pHist) {
+  OS_U32 i;
+
+  pHist->NumSamples = 0u;
+  pHist->Min        = 0xFFFFFFFFu;
+  pHist->Max        = 0u;
+  pHist->Mean       = 0u;
+  pHist->Sum        = 0u;
+  for (i = 0u; i < BSP_TICK_STAT_NUM_BUCKETS; i++) {
+    pHist->aBucket[i] = 0u;
+  }
+}
+
+/*********************************************************************
+*
+*       _AddSample()
+*
+*  Function description
+*    Adds a sample to a log2-bucketed histogram.
+*/
+static void _AddSample(BSP_TICK_HISTOGRAM* pHist, OS_U32 Value) {
+  pHist->aBucket[_GetBucket(Value, BSP_TICK_STAT_NUM_BUCKETS)]++;
+  pHist->NumSamples++;
+  pHist->Sum += Value;
+  if (Value < pHist->Min) {
+    pHist->Min = Value;
+  }
+  if (Value > pHist->Max) {
+    pHist->Max = Value;
+  }
+}
+#endif
+
+#if (IRQ_STATISTICS != 0)
+/*********************************************************************
+*
+*       _ResetIRQStat()
+*/
+static void _ResetIRQStat(BSP_IRQ_STAT* pStat) {
+  OS_U32 i;
+
+  pStat->NumCalls    = 0u;
+  pStat->LatencyMin  = 0xFFFFFFFFu;
+  pStat->LatencyMax  = 0u;
+  pStat->DurationMin = 0xFFFFFFFFu;
+  pStat->DurationMax = 0u;
+  for (i = 0u; i < IRQ_STAT_NUM_BUCKETS; i++) {
+    pStat->aLatency[i]  = 0u;
+    pStat->aDuration[i] = 0u;
+  }
+}
+
+/*********************************************************************
+*
+*       _AddIRQSample()
+*
+*  Parameters
+*    pStat:    Statistics of the interrupt source.
+*    Latency:  CPU cycles from OS_TrapHandler() entry to handler start.
+*    Duration: CPU cycles from handler start to handler return.
+*/
+static void _AddIRQSample(BSP_IRQ_STAT* pStat, OS_U32 Latency, OS_U32 Duration) {
+  pStat->NumCalls++;
+  pStat->aLatency[_GetBucket(Latency, IRQ_STAT_NUM_BUCKETS)]++;
+  pStat->aDuration[_GetBucket(Duration, IRQ_STAT_NUM_BUCKETS)]++;
+  if (Latency < pStat->LatencyMin) {
+    pStat->LatencyMin = Latency;
+  }
+  if (Latency > pStat->LatencyMax) {
+    pStat->LatencyMax = Latency;
+  }
+  if (Duration < pStat->DurationMin) {
+    pStat->DurationMin = Duration;
+  }
+  if (Duration > pStat->DurationMax) {
+    pStat->DurationMax = Duration;
+  }
+}
+
+/*********************************************************************
+*
+*       _GetTimerLatency()
+*
+*  Function description
+*    Returns the CPU cycles since the machine timer interrupt became
+*    due, i.e. MTIME - MTIMECMP as in _HandleTimer().
+*
+*  Additional information
+*    Unlike a timestamp taken in software, this includes the hardware
+*    latency and the register save of trap_entry.
+*/
+static OS_U32 _GetTimerLatency(void) {
+  OS_U64 Counter;
+  OS_U64 Compare;
+
+  Counter = MTIME;
+#if (DEADLINE_SERVICE != 0)
+  Compare = (_DeadlineCompare < _TickCompare) ? _DeadlineCompare : _TickCompare;
+#else
+  Compare = _TickCompare;
+#endif
+  if (Compare > Counter) {
+    return 0u;             // Not due, the interrupt was pending from before the compare value was updated
+  }
+  return (OS_U32)(((Counter - Compare) * BSP_TS_CYCLE_FREQ) / BSP_TS_MTIME_FREQ);
+}
+#endif
+
+#if (IRQ_COUNTERS != 0)
+/*********************************************************************
+*
+*       _CopyCounts()
+*
+*  Function description
+*    Copies up to NumDest counters of BSP_IRQ_GetCounts(). The rates are
+*    calculated later, with interrupts enabled.
+*/
+static void _CopyCounts(BSP_IRQ_COUNT* paDest, OS_U32 NumDest, const OS_U32* paSrc, OS_U32 NumSrc) {
+  OS_U32 i;
+
+  if (paDest != NULL) {
+    for (i = 0u; (i < NumDest) && (i < NumSrc); i++) {
+      paDest[i].NumCalls = paSrc[i];
+    }
+  }
+}
+
+/*********************************************************************
+*
+*       _CalcRates()
+*
+*  Function description
+*    Calculates the calls per second of counters copied by _CopyCounts().
+*/
+static void _CalcRates(BSP_IRQ_COUNT* paCount, OS_U32 NumCounts, OS_U32 NumSrc, OS_U64 Period_us) {
+  OS_U32 i;
+
+  if (paCount != NULL) {
+    for (i = 0u; (i < NumCounts) && (i < NumSrc); i++) {
+      paCount[i].Rate = (Period_us != 0u) ? (OS_U32)(((OS_U64)paCount[i].NumCalls * 1000000u) / Period_us) : 0u;
+    }
+  }
 }
+#endif
 
 /*********************************************************************
 *
@@ -201,8 +569,24 @@ static void _ExceptionHandler(OS_REG_TYPE mcause, OS_REG_TYPE mepc) {
 *  Additional information
 *    _ISR_NotInstalled() is called when an interrupt is pending for
 *    which no specific interrupt handler was previously installed.
+*
+*    With IRQ_COUNTERS enabled, the call is counted, see
+*    BSP_IRQ_GetCounts(), and the source is masked so that the
+*    application keeps running: a global IRQ via OS_PLIC_DisableInt(),
+*    a core-local interrupt by clearing its bit in mie.
 */
 static void _ISR_NotInstalled(void) {
+#if (IRQ_COUNTERS != 0)
+  OS_U32 Source;
+
+  _NumNotInstalled++;
+  Source = _ActiveIRQ;
+  if (Source >= NUM_LOCAL_INTERRUPTS) {
+    OS_PLIC_DisableInt(Source - NUM_LOCAL_INTERRUPTS);  // The claim is completed by the caller nonetheless.
+  } else if (Source < 32u) {                           // Causes above 31 have no bit in mie.
+    __asm volatile("csrc mie, %0" : : "r"(1u << Source));
+  }
+#else
   volatile int Dummy;
 
   Dummy = 1;
@@ -211,6 +595,7 @@ static void _ISR_NotInstalled(void) {
     // You may set a breakpoint here to detect Interrupts for which no ISR was registered
     //
   }
+#endif
 }
 
 #if (EXTEND_GLOBAL_ISR_CONTEXT != 0)
@@ -224,159 +609,720 @@ static void _ISR_NotInstalled(void) {
 *  Additional information
 *    _ISR_NotInstalled_Ex() is called when an interrupt is pending for
 *    which no specific interrupt handler was previously installed.
+*
+*    With IRQ_COUNTERS enabled, the call is counted and the IRQ, whose
+*    index is passed as context, is masked, see _ISR_NotInstalled().
 */
 static void _ISR_NotInstalled_Ex(void* pContext) {
+#if (IRQ_COUNTERS != 0)
+  _NumNotInstalled++;
+  OS_PLIC_DisableInt((OS_U32)(uintptr_t)pContext);
+#else
   volatile int Dummy;
 
   OS_USE_PARA(pContext);
-
   Dummy = 1;
   while (Dummy > 0) {
     //
     // You may set a breakpoint here to detect Interrupts for which no ISR was registered
     //
   }
-}
 #endif
+}
 
 /*********************************************************************
 *
-*       Global functions
+*       _CallLegacyISR()
 *
-**********************************************************************
+*  Function description
+*    Default entry of _aPLIC_ISR_Ex[]. Calls the handler installed via
+*    OS_PLIC_InstallISR() for the IRQ index passed as context.
 */
+static void _CallLegacyISR(void* pContext) {
+  PLIC_ISR((OS_U32)(uintptr_t)pContext)();
+}
 
 /*********************************************************************
 *
-*       ISR_M_Software()
+*       _SetDefaultISR_Ex()
 *
 *  Function description
-*    This routine does not serve any specific purpose, but is included
-*    for demonstration only.
+*    Sets the entry of a global IRQ in _aPLIC_ISR_Ex[] to its default.
 *
 *  Additional information
-*    ISR_M_Software() is called when the Machine Software interrupt is pending.
-*    Machine Software interrupt becomes pending when bit 3 (MSIP) of the
-*    Machine Interrupt Pending Register (MIP) is set.
+*    With ISR_TABLE_CONST, handlers cannot be installed via
+*    OS_PLIC_InstallISR(), hence IRQs without a handler in the const
+*    table call _ISR_NotInstalled_Ex() directly.
 */
-void ISR_M_Software(void) {
-  OS_INT_Enter();
-  OS_CLINT_ClearIntPending(IRQ_M_SOFTWARE);  // Explicitly clear MSIP bit.
-  //
-  // Perform any functionality here.
-  //
-  OS_INT_Leave();
+static void _SetDefaultISR_Ex(OS_U32 IRQIndex) {
+  _aPLIC_ISR_Ex[IRQIndex].pContext = (void*)(uintptr_t)IRQIndex;
+#if (ISR_TABLE_CONST != 0)
+  if (PLIC_ISR(IRQIndex) == _ISR_NotInstalled) {
+    _aPLIC_ISR_Ex[IRQIndex].pfISR = _ISR_NotInstalled_Ex;
+    return;
+  }
+#endif
+  _aPLIC_ISR_Ex[IRQIndex].pfISR = _CallLegacyISR;
 }
 
 /*********************************************************************
 *
-*       ISR_M_Timer()
-*
-*  Function description
-*    This routine performs the embOS tick handling.
+*       _IsDefaultISR_Ex()
 *
-*  Additional information
-*    ISR_M_Timer() is called when the Machine Timer interrupt is pending.
-*    Machine Timer Interrupt becomes pending when (MTIMECMP >= MTIME).
+*  Return value
+*    == 0: A handler was installed via BSP_PLIC_InstallISR_Ex().
+*    != 0: Entry is set to its default.
 */
-void ISR_M_Timer(void) {
-  OS_U64 Compare;
+static int _IsDefaultISR_Ex(OS_U32 IRQIndex) {
+  return ((_aPLIC_ISR_Ex[IRQIndex].pfISR == _CallLegacyISR) || (_aPLIC_ISR_Ex[IRQIndex].pfISR == _ISR_NotInstalled_Ex)) ? 1 : 0;
+}
+#endif
 
-  OS_INT_Enter();
-  Compare = MTIMECMP;  // Read timer compare value
-  do {                 // We might have to perform numerous ticks if (machine timer) interrupt has been disabled for extended periods
-    OS_TICK_Handle();
-    Compare += OS_TIMER_RELOAD;
-  } while (Compare <= MTIME);
-  MTIMECMP = Compare;  // Eventually, write new compare value. Implicitly clears MTIP bit.
-  OS_INT_Leave();
+#if (OS_VIEW_IFSELECT == OS_VIEW_IF_UART)
+/*********************************************************************
+*
+*       _OS_OnRx()
+*
+*  Function description
+*    Read callback of the embOSView UART.
+*/
+static void _OS_OnRx(unsigned int Unit, unsigned char Data) {
+  OS_USE_PARA(Unit);
+  OS_COM_OnRx(Data);
 }
 
 /*********************************************************************
 *
-*       ISR_M_External()
+*       _OS_OnTx()
 *
 *  Function description
-*    This routine detects the specific reason for the global IRQ and
-*    calls the respective interrupt service routine that was previously
-*    installed by OS_PIC_InstallISR().
+*    Write callback of the embOSView UART.
 *
-*  Additional information
-*    ISR_M_External() is called when the Machine External interrupt is
-*    pending. Machine External interrupt becomes pending when it is
-*    asserted by the external Programmable Interrupt Controller (PIC).
+*  Return value
+*    == 0: embOSView queued its next character via OS_COM_Send1().
+*    != 0: Nothing to send.
 */
-void ISR_M_External(void) {
-  OS_U32 IRQIndex;
-  OS_INT_Enter();
-  IRQIndex = OS_PLIC_ClaimInt();   // Claim highest-priority global IRQ.
-  if (IRQIndex != 0u) {            // "0" indicates no IRQ was pending.
-    plic_isr[IRQIndex]();    // Call appropriate handler.
-    OS_PLIC_CompleteInt(IRQIndex); // Signal interrupt completion to PLIC.
-  }
-  OS_INT_Leave();
+static int _OS_OnTx(unsigned int Unit) {
+  OS_USE_PARA(Unit);
+  return (int)OS_COM_OnTx();
 }
+#endif
 
 /*********************************************************************
 *
-*       OS_TrapHandler()
+*       _CallISR()
 *
 *  Function description
-*    This routine is used to handle traps routed to the mtvec vector.
-*    It checks whether the trap was caused by an exception or an
-*    interrupt and decides how to continue trap handling.
+*    Calls the handler of a claimed global IRQ.
 *
 *  Additional information
-*    Handling of traps highly depends on the implemented interrupt
-*    controller and the used mode. Thus, the implementation of the
-*    OS_TrapHandler() might me different for other RISC-V devices.
+*    With EXTEND_GLOBAL_ISR_CONTEXT, _aPLIC_ISR_Ex[] is the only dispatch
+*    table. Each entry is set, either to a handler installed via
+*    BSP_PLIC_InstallISR_Ex() or to its default, hence a single call
+*    without any check serves the IRQ.
 *
-*    OS_TrapHandler() forwards exceptions to _ExceptionHandler().
+*    With IRQ_COUNTERS enabled, the IRQ is recorded as the active source
+*    for _ISR_NotInstalled(). The previous source is restored after the
+*    call, as handlers may nest.
 */
-OS_REG_TYPE OS_TrapHandler(OS_REG_TYPE mcause, OS_REG_TYPE mepc) {
-  if (mcause & MCAUSE_INT) {
-    //
-    // Caused by interrupt: call appropriate high-level handler.
-    //
-    clint_isr[mcause & MCAUSE_CAUSE]();
-  } else {
-    //
-    // Caused by synchronous trap: call fault handler.
-    //
-    _ExceptionHandler(mcause, mepc);
-  }
-  return mepc;
+static void _CallISR(OS_U32 IRQIndex) {
+#if (IRQ_COUNTERS != 0)
+  OS_U32 Prev;
+
+  Prev       = _ActiveIRQ;
+  _ActiveIRQ = NUM_LOCAL_INTERRUPTS + IRQIndex;
+#endif
+#if (EXTEND_GLOBAL_ISR_CONTEXT != 0)
+  _aPLIC_ISR_Ex[IRQIndex].pfISR(_aPLIC_ISR_Ex[IRQIndex].pContext);
+#else
+  PLIC_ISR(IRQIndex)();            // Call appropriate handler.
+#endif
+#if (IRQ_COUNTERS != 0)
+  _ActiveIRQ = Prev;
+#endif
 }
 
+#if (INT_STACK != 0)
 /*********************************************************************
 *
-*       OS_InitHW()
+*       _CallOnIntStack()
 *
 *  Function description
-*    Initialize the hardware required for embOS to run.
+*    Calls an interrupt routine on the system stack.
+*
+*  Additional information
+*    Must be called with interrupts disabled, before OS_INT_Leave().
+*    OS__EnterIntStack() is called instead of OS_INT_EnterIntStack(),
+*    which would enable interrupts for nestable and zero-latency entries
+*    before the PLIC threshold is set up. The function must not be
+*    inlined: apart from the routine and its parameter, which are kept
+*    in callee-saved registers, it must not access its stack frame while
+*    the stack pointer is switched.
 */
-static const OS_SYSTIMER_CONFIG _SysTimerConfig = {OS_TIMER_FREQ, OS_INT_FREQ, OS_TIMER_UPCOUNTING, _OS_GetHWTimerCycles, _OS_GetHWTimer_IntPending};
-void OS_InitHW(void) {
-  OS_INT_IncDI();
-  //
+static __attribute__((noinline)) void _CallOnIntStack(INT_ROUTINE* pfRoutine, void* p) {
+  OS__EnterIntStack();
+  pfRoutine(p);
+  OS_INT_LeaveIntStack();
+}
+#endif
+
+#if (IRQ_STORM_DETECTION != 0)
+/*********************************************************************
+*
+*       _IsEmbOSIRQ()
+*
+*  Return value
+*    == 0: Zero-latency IRQ.
+*    != 0: IRQ is served as embOS interrupt.
+*/
+static int _IsEmbOSIRQ(OS_U32 IRQIndex) {
+#if (ZERO_LATENCY_TIER != 0)
+  return (_aIsZeroLatency[IRQIndex] == 0u) ? 1 : 0;
+#else
+  OS_USE_PARA(IRQIndex);
+  return 1;
+#endif
+}
+#endif
+
+#if (INT_STACK != 0)
+/*********************************************************************
+*
+*       _FillIntStack()
+*
+*  Function description
+*    Fills the unused part of the system stack with INT_STACK_FILL.
+*
+*  Additional information
+*    Called by OS_InitHW(), which runs on the system stack itself. The
+*    part above the current stack pointer is therefore counted as used.
+*/
+static void _FillIntStack(void) {
+  OS_U32* p;
+  OS_U32* pEnd;
+
+  __asm volatile("mv %0, sp" : "=r"(pEnd));
+  pEnd = (OS_U32*)((OS_U8*)pEnd - INT_STACK_MARGIN);
+  for (p = __stack_start__; p < pEnd; p++) {
+    *p = INT_STACK_FILL;
+  }
+}
+#endif
+
+#if (TICKLESS_IDLE != 0)
+/*********************************************************************
+*
+*       _EndTicklessMode()
+*
+*  Function description
+*    Called by embOS when the tickless period ends, either because the
+*    programmed timeout expired or because another interrupt woke up a
+*    task before.
+*
+*  Additional information
+*    Adjusts the embOS time by the number of ticks that passed without
+*    a timer interrupt and restores the periodic tick on the original
+*    tick grid.
+*/
+static void _EndTicklessMode(void) {
+  OS_TIME NumTicks;
+  OS_TIME Period;
+  OS_U64  Counter;
+
+  Period = OS_TICKLESS_GetPeriod();
+  if (OS_TICKLESS_IsExpired() != 0u) {
+    //
+    // Timeout expired: OS_TICK_Handle() accounts for the last tick of the period,
+    // ISR_M_Timer() reprograms the compare register afterwards.
+    //
+    NumTicks = Period - 1;
+  } else {
+    //
+    // Woken up early: count the tick boundaries which already passed.
+    //
+    Counter  = MTIME;
+    NumTicks = 0;
+    if (Counter >= _TicklessBase) {
+      NumTicks = (OS_TIME)((Counter - _TicklessBase) / _TimerReload) + 1;
+    }
+    if (NumTicks >= Period) {
+      NumTicks = Period - 1;  // Timer interrupt is already pending and handles the last tick
+    }
+    _TickCompare = _TicklessBase + ((OS_U64)NumTicks * _TimerReload);
+    _UpdateCompare();
+  }
+  OS_TICKLESS_AdjustTime(NumTicks);
+  _NumSkippedTicks += (OS_U32)NumTicks;
+  OS_TICKLESS_Stop();
+}
+#endif
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       _HandleSoftware()
+*
+*  Function description
+*    Machine Software interrupt handling of ISR_M_Software().
+*/
+static void _HandleSoftware(void* p) {
+#if (ZERO_LATENCY_TIER != 0)
+  OS_U32 IRQIndex;
+#endif
+
+  OS_USE_PARA(p);
+  OS_CLINT_ClearIntPending(IRQ_M_SOFTWARE);  // Explicitly clear MSIP bit.
+#if (ZERO_LATENCY_TIER != 0)
+  for (IRQIndex = 1u; IRQIndex < PLIC_NUM_INTERRUPTS; IRQIndex++) {
+    if (_aIsDeferred[IRQIndex] != 0u) {
+      _aIsDeferred[IRQIndex] = 0u;
+      _CallISR(IRQIndex);
+      COMPLETE_INT(IRQIndex);
+    }
+  }
+#endif
+  //
+  // Perform any functionality here.
+  //
+}
+
+/*********************************************************************
+*
+*       ISR_M_Software()
+*
+*  Function description
+*    This routine does not serve any specific purpose, but is included
+*    for demonstration only.
+*
+*  Additional information
+*    ISR_M_Software() is called when the Machine Software interrupt is pending.
+*    Machine Software interrupt becomes pending when bit 3 (MSIP) of the
+*    Machine Interrupt Pending Register (MIP) is set.
+*
+*    With ZERO_LATENCY_TIER enabled, it serves embOS-tier global IRQs
+*    which ISR_M_External() claimed while embOS interrupts were disabled
+*    by BSP_INT_DisableEmbOS().
+*/
+void ISR_M_Software(void) {
+  OS_INT_Enter();
+  CALL_INT_ROUTINE(_HandleSoftware, NULL);
+  OS_INT_Leave();
+}
+
+/*********************************************************************
+*
+*       _HandleTimer()
+*
+*  Function description
+*    Tick and deadline handling of ISR_M_Timer().
+*
+*  Parameters
+*    p: Pointer to the MTIME value at interrupt entry (TICK_STATISTICS).
+*/
+static void _HandleTimer(void* p) {
+  OS_U64 Compare;
+#if (TICK_CATCHUP_BULK != 0)
+  OS_U64 Counter;
+  OS_U32 NumMissed;
+#endif
+#if (TICK_STATISTICS != 0)
+  OS_U64 Entry;
+  OS_U32 Start;
+
+  Entry = *(OS_U64*)p;
+#else
+  OS_USE_PARA(p);
+#endif
+  Compare = _TickCompare;  // Read timer compare value of the next tick
+  if (Compare <= MTIME) {
+#if (TICK_STATISTICS != 0)
+    //
+    // With DEADLINE_SERVICE, the interrupt may have been entered for a
+    // deadline, and the tick became due only afterwards. Its entry was
+    // not late then, hence no latency is recorded.
+    //
+    if (Compare <= Entry) {
+      _AddSample(&_TickStat.Latency, (OS_U32)(Entry - Compare));
+    }
+    Start = BSP_TS_GetCycles();
+#endif
+#if (TICK_CATCHUP_BULK != 0)
+    //
+    // If the (machine timer) interrupt has been disabled for extended periods,
+    // account for all missed ticks at once instead of calling OS_TICK_Handle() for each one.
+    // Not possible with a fractional tick, which is handled per interrupt by OS_TICK_HandleEx().
+    //
+    Counter = MTIME;
+    if ((_IsFractionalTick == 0u) && (Counter >= (Compare + _TimerReload))) {
+      NumMissed = (OS_U32)((Counter - Compare) / _TimerReload);
+      OS_TICKLESS_AdjustTime((OS_TIME)NumMissed);
+      Compare            += (OS_U64)NumMissed * _TimerReload;
+      _NumCoalescedTicks += NumMissed;
+    }
+#endif
+    do {                   // We might have to perform numerous ticks if (machine timer) interrupt has been disabled for extended periods
+      if (_IsFractionalTick != 0u) {
+        OS_TICK_HandleEx();
+      } else {
+        OS_TICK_Handle();
+      }
+      Compare += _TimerReload;
+    } while (Compare <= MTIME);
+    _TickCompare = Compare;
+#if (TICK_STATISTICS != 0)
+    _AddSample(&_TickStat.Duration, BSP_TS_GetCycles() - Start);
+#endif
+  }
+#if (DEADLINE_SERVICE != 0)
+  if (_DeadlineCompare <= MTIME) {
+    BSP_DEADLINE_Handle();  // Executes expired deadlines and calls BSP_MTIMER_SetDeadline() for the next one
+  }
+#endif
+  _UpdateCompare();        // Eventually, write new compare value. Implicitly clears MTIP bit.
+}
+
+/*********************************************************************
+*
+*       ISR_M_Timer()
+*
+*  Function description
+*    This routine performs the embOS tick handling.
+*
+*  Additional information
+*    ISR_M_Timer() is called when the Machine Timer interrupt is pending.
+*    Machine Timer Interrupt becomes pending when (MTIMECMP >= MTIME).
+*
+*    With TICK_CATCHUP_BULK enabled, missed ticks are accounted for in
+*    one step via OS_TICKLESS_AdjustTime(), which keeps the worst-case
+*    execution time of this ISR constant.
+*
+*    With TICK_STATISTICS enabled, the lateness of the interrupt entry
+*    and the duration of the tick handling are recorded, see
+*    BSP_TICK_GetStat().
+*
+*    With DEADLINE_SERVICE enabled, the compare register is shared with
+*    the high-resolution deadlines of BSP_Deadline.c. The interrupt is
+*    then caused by a tick, a deadline, or both.
+*/
+void ISR_M_Timer(void) {
+#if (TICK_STATISTICS != 0)
+  OS_U64 Entry;
+
+  Entry = MTIME;
+  OS_INT_Enter();
+  CALL_INT_ROUTINE(_HandleTimer, &Entry);
+#else
+  OS_INT_Enter();
+  CALL_INT_ROUTINE(_HandleTimer, NULL);
+#endif
+  OS_INT_Leave();
+}
+
+/*********************************************************************
+*
+*       _ServePLIC()
+*
+*  Function description
+*    Claims and serves global IRQs for ISR_M_External().
+*
+*  Parameters
+*    pIsEntered: Receives whether embOS was entered, which is the case
+*                unless only zero-latency IRQs were served.
+*/
+static void _ServePLIC(void* pIsEntered) {
+  OS_U32  IRQIndex;
+  OS_U32  NumServed;
+  OS_BOOL IsEntered;
+#if (PLIC_NESTABLE != 0)
+  OS_U32  Threshold;
+#endif
+#if (IRQ_STATISTICS != 0)
+  OS_U32  Entry;
+  OS_U32  Start;
+
+#if (CLINT_VECTORED_MODE != 0)
+  Entry = BSP_TS_GetCycles();        // Entered via vtrap_entry, OS_TrapHandler() was bypassed
+#else
+  Entry = _IRQEntry;                 // Read before a nested entry overwrites it
+#endif
+#endif
+#if (PLIC_NESTABLE != 0)
+  Threshold = PLIC_THRESHOLD;        // Threshold of the interrupted context, restored after each handler
+  __asm volatile("csrc mie, %0" : : "r"(1u << IRQ_M_EXTERNAL));  // No global IRQ may nest before the threshold was raised
+#endif
+#if (ZERO_LATENCY_TIER != 0)
+  IsEntered = 0u;
+#else
+  ENTER_INT();
+  IsEntered = 1u;
+#endif
+  NumServed = 0u;
+  do {
+    IRQIndex = CLAIM_INT();          // Claim highest-priority global IRQ.
+    if (IRQIndex == 0u) {            // "0" indicates no IRQ was pending.
+#if (IRQ_COUNTERS != 0)
+      if (NumServed == 0u) {
+        _NumSpurious++;
+      }
+#endif
+      break;
+    }
+#if (IRQ_COUNTERS != 0)
+    _aPLICCnt[IRQIndex]++;
+#endif
+#if (ZERO_LATENCY_TIER != 0)
+    if (_aIsZeroLatency[IRQIndex] == 0u) {
+      if (_EmbOSDisableCnt != 0u) {
+        _aIsDeferred[IRQIndex] = 1u;  // Keep the IRQ claimed until embOS interrupts are enabled again.
+        __asm volatile("csrs mip, %0" : : "r"(1u << IRQ_M_SOFTWARE));
+        NumServed++;
+        continue;
+      }
+      if (IsEntered == 0u) {
+        ENTER_INT();
+        IsEntered = 1u;
+      }
+    }
+#endif
+#if (PLIC_NESTABLE != 0)
+  #if (ZERO_LATENCY_TIER != 0)
+    if (IsEntered != 0u)             // Nesting requires embOS to be informed, else a nested tick could switch tasks.
+  #endif
+    {
+      PLIC_THRESHOLD = PLIC_PRIORITY(IRQIndex);
+      (void)PLIC_THRESHOLD;          // Read back, so that the threshold is effective before interrupts are enabled
+      _NestDepth++;
+      if (_NestDepth > _NestStat.MaxDepth) {
+        _NestStat.MaxDepth = _NestDepth;
+      }
+      if (_NestDepth > 1u) {         // Preempted another handler, whose priority is the entry threshold
+        _NestStat.NumNested++;
+        if (PLIC_PRIORITY(IRQIndex) <= Threshold) {
+          _NestStat.NumOrderErrors++;
+        }
+      }
+      __asm volatile("csrs mie, %0" : : "r"(1u << IRQ_M_EXTERNAL));
+      OS_INT_Enable();
+    }
+#endif
+#if (IRQ_STATISTICS != 0)
+    Start = BSP_TS_GetCycles();
+#endif
+    _CallISR(IRQIndex);
+#if (IRQ_STATISTICS != 0)
+    _AddIRQSample(&_aPLICStat[IRQIndex], Start - Entry, BSP_TS_GetCycles() - Start);
+#endif
+#if (PLIC_NESTABLE != 0)
+    OS_INT_Disable();
+    PLIC_THRESHOLD = Threshold;
+  #if (ZERO_LATENCY_TIER != 0)
+    if (IsEntered != 0u)
+  #endif
+    {
+      _NestDepth--;
+    }
+#endif
+#if (IRQ_STORM_DETECTION != 0)
+    if (_IsEmbOSIRQ(IRQIndex) != 0) {
+      BSP_STORM_Count(IRQIndex);     // May mask the IRQ, it is completed nonetheless.
+    }
+#endif
+    COMPLETE_INT(IRQIndex);          // Signal interrupt completion to PLIC.
+    NumServed++;
+  } while (NumServed < PLIC_MAX_CLAIMS_PER_ENTRY);
+#if (PLIC_DRAIN_STATISTICS != 0)
+  _DrainStat.NumEntries++;
+  _DrainStat.NumServed += NumServed;
+  _DrainStat.aServedPerEntry[NumServed]++;
+#endif
+#if (PLIC_NESTABLE != 0)
+  __asm volatile("csrs mie, %0" : : "r"(1u << IRQ_M_EXTERNAL));  // Interrupts are disabled here
+#endif
+  *(OS_BOOL*)pIsEntered = IsEntered;
+}
+
+/*********************************************************************
+*
+*       ISR_M_External()
+*
+*  Function description
+*    This routine detects the specific reason for the global IRQ and
+*    calls the respective interrupt service routine that was previously
+*    installed by BSP_PLIC_InstallISR_Ex() or OS_PLIC_InstallISR().
+*
+*  Additional information
+*    ISR_M_External() is called when the Machine External interrupt is
+*    pending. Machine External interrupt becomes pending when it is
+*    asserted by the external Programmable Interrupt Controller (PIC).
+*
+*    All pending global IRQs are served within one entry, until the
+*    claim register returns 0 or PLIC_MAX_CLAIMS_PER_ENTRY IRQs were
+*    served. The bound limits the time other interrupts and tasks are
+*    held off; remaining IRQs re-trigger the interrupt right away.
+*
+*    With PLIC_DRAIN_STATISTICS enabled, the number of IRQs served per
+*    entry is recorded, see BSP_PLIC_GetDrainStat().
+*
+*    With IRQ_STATISTICS enabled, latency and duration of each global
+*    interrupt are recorded, see BSP_IRQ_GetPLICStat().
+*
+*    With ZERO_LATENCY_TIER enabled, OS_INT_Enter() is called only before
+*    the first embOS-tier IRQ is served. An entry which serves only
+*    zero-latency IRQs does not inform embOS at all, hence their handlers
+*    must not call any embOS API. Since the claim register does not have
+*    to honor the PLIC threshold, an embOS-tier IRQ may be claimed while
+*    embOS interrupts are disabled by BSP_INT_DisableEmbOS(). It is then
+*    left claimed and served by ISR_M_Software() afterwards.
+*
+*    With IRQ_COUNTERS enabled, each claimed IRQ and each entry without
+*    a pending IRQ is counted, see BSP_IRQ_GetCounts().
+*
+*    With IRQ_STORM_DETECTION enabled, embOS-tier IRQs which exceed the
+*    rate limit of BSP_IRQStorm.c are masked and polled by a task.
+*
+*    With INT_STACK enabled, the IRQs are served on the interrupt stack,
+*    which is left before OS_INT_Leave() may switch tasks.
+*
+*    With PLIC_NESTABLE enabled, embOS is entered via
+*    OS_INT_EnterNestable(). Each handler runs with the PLIC threshold
+*    set to the priority of its IRQ and interrupts enabled, hence only
+*    IRQs of higher priority and the core-local interrupts preempt it.
+*    Zero-latency IRQs served without entering embOS are not nestable.
+*    The nesting depth and priority order are recorded, see
+*    BSP_PLIC_GetNestStat().
+*/
+void ISR_M_External(void) {
+  OS_BOOL IsEntered;
+
+  CALL_INT_ROUTINE(_ServePLIC, &IsEntered);
+  if (IsEntered != 0u) {
+    LEAVE_INT();                     // Not before the interrupt stack was left, as it may switch tasks.
+  }
+}
+
+/*********************************************************************
+*
+*       OS_TrapHandler()
+*
+*  Function description
+*    This routine is used to handle traps routed to the mtvec vector.
+*    It checks whether the trap was caused by an exception or an
+*    interrupt and decides how to continue trap handling.
+*
+*  Additional information
+*    Handling of traps highly depends on the implemented interrupt
+*    controller and the used mode. Thus, the implementation of the
+*    OS_TrapHandler() might me different for other RISC-V devices.
+*
+*    OS_TrapHandler() forwards exceptions to _ExceptionHandler().
+*
+*    With IRQ_STATISTICS enabled, latency and duration of core-local
+*    interrupts are recorded, see BSP_IRQ_GetCLINTStat(). The entry
+*    timestamp is also the latency base of ISR_M_External(). The
+*    register save in trap_entry of the embOS library precedes it and
+*    cannot be included.
+*
+*    With IRQ_COUNTERS enabled, the calls of each core-local interrupt
+*    are counted, see BSP_IRQ_GetCounts(). The cause is recorded as the
+*    active source for _ISR_NotInstalled().
+*/
+OS_REG_TYPE OS_TrapHandler(OS_REG_TYPE mcause, OS_REG_TYPE mepc) {
+#if (IRQ_COUNTERS != 0)
+  OS_U32 Prev;
+#endif
+#if (IRQ_STATISTICS != 0)
+  OS_U32 Latency;
+  OS_U32 Start;
+
+  _IRQEntry = BSP_TS_GetCycles();
+#endif
+  if (mcause & MCAUSE_INT) {
+    //
+    // Caused by interrupt: call appropriate high-level handler.
+    //
+#if (IRQ_COUNTERS != 0)
+    _aCLINTCnt[mcause & MCAUSE_CAUSE]++;
+    Prev       = _ActiveIRQ;
+    _ActiveIRQ = mcause & MCAUSE_CAUSE;
+#endif
+#if (IRQ_STATISTICS != 0)
+    if ((mcause & MCAUSE_CAUSE) == IRQ_M_TIMER) {
+      Latency = _GetTimerLatency();
+      Start   = BSP_TS_GetCycles();
+    } else {
+      Start   = BSP_TS_GetCycles();
+      Latency = Start - _IRQEntry;
+    }
+    CLINT_ISR(mcause & MCAUSE_CAUSE)();
+    _AddIRQSample(&_aCLINTStat[mcause & MCAUSE_CAUSE], Latency, BSP_TS_GetCycles() - Start);
+#else
+    CLINT_ISR(mcause & MCAUSE_CAUSE)();
+#endif
+#if (IRQ_COUNTERS != 0)
+    _ActiveIRQ = Prev;
+#endif
+  } else {
+    //
+    // Caused by synchronous trap: call fault handler.
+    //
+    _ExceptionHandler(mcause, mepc);
+  }
+  return mepc;
+}
+
+/*********************************************************************
+*
+*       OS_InitHW()
+*
+*  Function description
+*    Initialize the hardware required for embOS to run.
+*
+*  Additional information
+*    With ISR_TABLE_CONST enabled, the handler tables are complete at
+*    compile time, hence no handlers are installed here. The CPU cycles
+*    up to and within OS_InitHW() are recorded, see BSP_BOOT_GetStat().
+*/
+static OS_SYSTIMER_CONFIG _SysTimerConfig = {OS_TIMER_FREQ, OS_INT_FREQ, OS_TIMER_UPCOUNTING, _OS_GetHWTimerCycles, _OS_GetHWTimer_IntPending};
+void OS_InitHW(void) {
+  _BootStat.InitHWStart = BSP_TS_GetCycles();                               // mcycle counts from reset
+  OS_INT_IncDI();
+  //
   // Initialize core-local interrupt handling
   //
+#if (ISR_TABLE_CONST != 0)
+  OS_CLINT_Init(NUM_LOCAL_INTERRUPTS, (OS_IRQ_HANDLER**)_apCLINT_ISR);      // Implicitly disables all sources, the table is only stored
+#else
   OS_CLINT_Init(NUM_LOCAL_INTERRUPTS, clint_isr);                           // Implicitly disables all sources
   for (CLINT_IRQn i = IRQ_U_SOFTWARE; i < NUM_LOCAL_INTERRUPTS; i++) {
     if (clint_isr[i] == NULL) {
       (void)OS_CLINT_InstallISR(i, _ISR_NotInstalled);                        // Install dummy handler (allows to omit NULL-pointer checks in OS_TrapHandler())
     }
   }
+#endif
+#if (CLINT_VECTORED_MODE != 0)
+  OS_CLINT_SetVectoredMode();                                               // Use vtrap_entry, which enters ISR_M_Software/Timer/External() without OS_TrapHandler()
+#else
   OS_CLINT_SetDirectMode();                                                 // Replace the default trap_entry which was set during startup and set mode to direct
+#endif
   //
   // Install and enable Machine Timer Interrupt
   //
+#if (ISR_TABLE_CONST == 0)
   (void)OS_CLINT_InstallISR(IRQ_M_TIMER, ISR_M_Timer);
+#endif
   OS_CLINT_EnableInt(IRQ_M_TIMER);
   //
   // Install and enable Machine External Interrupt
   //
+#if (ISR_TABLE_CONST == 0)
   (void)OS_CLINT_InstallISR(IRQ_M_EXTERNAL, ISR_M_External);
+#endif
   OS_CLINT_EnableInt(IRQ_M_EXTERNAL);
   //
   // Install and enable Machine Software Interrupt
@@ -385,29 +1331,54 @@ void OS_InitHW(void) {
   //
   // Initialize global interrupt handling (PLIC)
   //
+#if (ISR_TABLE_CONST != 0)
+  OS_PLIC_Init(PLIC_BASE_ADDR, PLIC_NUM_INTERRUPTS, PLIC_MAX_PRIORITY, (OS_IRQ_HANDLER**)_apPLIC_ISR);
+#else
   OS_PLIC_Init(PLIC_BASE_ADDR, PLIC_NUM_INTERRUPTS, PLIC_MAX_PRIORITY, plic_isr);
   for (PIC_IRQn i = IRQ_S0; i < PLIC_NUM_INTERRUPTS; i++) {
     if (plic_isr[i] == NULL) {
       (void)OS_PLIC_InstallISR(i, _ISR_NotInstalled);                          // Install dummy handler (allows to omit NULL-pointer checks in ISR_M_External()) {}
     }
   }
+#endif
+#if (EXTEND_GLOBAL_ISR_CONTEXT != 0)
+  for (OS_U32 i = 0u; i < PLIC_NUM_INTERRUPTS; i++) {
+    if (_aPLIC_ISR_Ex[i].pfISR == NULL) {                                   // Keep handlers installed via BSP_PLIC_InstallISR_Ex() before
+      _SetDefaultISR_Ex(i);
+    }
+  }
+#endif
+#if (TICK_STATISTICS != 0)
+  BSP_TICK_ResetStat();
+#endif
+#if (IRQ_STATISTICS != 0)
+  BSP_IRQ_ResetStat();
+#endif
+#if (INT_STACK != 0)
+  _FillIntStack();
+#endif
+  //
+  // Set-up the OS tick interrupt timer
+  //
+  BSP_TS_MTIME_HI = 0u;                                                    // Configure counter register (must set the register to a non-zero value to start the counting process [1])
+  BSP_TS_MTIME_LO = 1u;
+  _TickCompare = _TimerReload + 1u;
+  _UpdateCompare();                                                        // Configure compare register
+  //
+  // Inform embOS about the timer settings
   //
-  // Set-up the OS tick interrupt timer
-  //
-  MTIME    = 1u;                                                           // Configure counter register (must set the register to a non-zero value to start the counting process [1])
-  MTIMECMP = OS_TIMER_RELOAD + 1u;                                         // Configure compare register
-  //
-  // Inform embOS about the timer settings
-  //
   OS_TIME_ConfigSysTimer(&_SysTimerConfig);
 #if (OS_VIEW_IFSELECT == OS_VIEW_IF_JLINK)
   JLINKMEM_SetpfOnRx(OS_COM_OnRx);
   JLINKMEM_SetpfOnTx(OS_COM_OnTx);
   JLINKMEM_SetpfGetNextChar(OS_COM_GetNextChar);
 #elif (OS_VIEW_IFSELECT == OS_VIEW_IF_UART)
+  BSP_UART_SetReadCallback(OS_UART, _OS_OnRx);
+  BSP_UART_SetWriteCallback(OS_UART, _OS_OnTx);
   BSP_UART_Init(OS_UART, OS_BAUDRATE, BSP_UART_DATA_BITS_8, BSP_UART_PARITY_NONE, BSP_UART_STOP_BITS_1);
 #endif
   OS_INT_DecRI();
+  _BootStat.InitHWDuration = BSP_TS_GetCycles() - _BootStat.InitHWStart;
 }
 
 /*********************************************************************
@@ -426,9 +1397,37 @@ void OS_InitHW(void) {
 *    The idle loop can be exited only when an embOS interrupt causes
 *    a context switch (e.g. after expiration of a task timeout),
 *    hence embOS interrupts must not permanently be disabled.
+*
+*    With TICKLESS_IDLE enabled, the machine timer compare register is
+*    moved out to the next embOS timeout, so that no tick interrupts
+*    occur while the system is idle.
 */
 void OS_Idle(void) {            // Idle loop: No task is ready to execute
+#if (TICKLESS_IDLE != 0)
+  OS_TIME IdleTicks;
+
+  OS_INT_IncDI();
+  IdleTicks = OS_TICKLESS_GetNumIdleTicks();
+#if (TIMER_WHEEL != 0)
+  if (IdleTicks > BSP_TWHEEL_GetNumIdleTicks()) {
+    IdleTicks = BSP_TWHEEL_GetNumIdleTicks();  // Timing wheel timers are not known to embOS
+  }
+#endif
+  if ((IdleTicks > 1) && (_IsFractionalTick == 0u)) {  // Tickless mode requires a 1:1 tick to interrupt ratio
+    if (IdleTicks > TICKLESS_MAX_IDLE_TICKS) {
+      IdleTicks = TICKLESS_MAX_IDLE_TICKS;
+    }
+    _TicklessBase = _TickCompare;  // Next tick boundary
+    OS_TICKLESS_Start(IdleTicks, _EndTicklessMode);
+    _TickCompare  = _TicklessBase + ((OS_U64)(IdleTicks - 1) * _TimerReload);
+    _UpdateCompare();
+  }
+  OS_INT_DecRI();
+#endif
   while (1) {                   // Nothing to do ... wait for interrupt
+#if (DEFERRED_LOG != 0)
+    BSP_LOG_OnIdle();           // Flushes the log ring if no flush task is used
+#endif
     #if (OS_DEBUG == 0)
       //
       // When uncommenting this line, please be aware device
@@ -440,6 +1439,613 @@ void OS_Idle(void) {            // Idle loop: No task is ready to execute
   }
 }
 
+#if (TICKLESS_IDLE != 0)
+/*********************************************************************
+*
+*       BSP_TICK_GetNumSkipped()
+*
+*  Function description
+*    Returns the number of system ticks which were skipped in tickless
+*    idle mode since OS_InitHW().
+*/
+OS_U32 BSP_TICK_GetNumSkipped(void) {
+  return _NumSkippedTicks;
+}
+#endif
+
+/*********************************************************************
+*
+*       BSP_TICK_SetFreq()
+*
+*  Function description
+*    Changes the system tick frequency and the timer interrupt
+*    frequency at runtime.
+*
+*  Parameters
+*    TickFreq: Frequency of the embOS time base in Hz, e.g. 10000 for
+*              a 100 us tick. OS_TIME values passed to embOS API
+*              functions are counted in units of this tick.
+*    IntFreq:  Frequency of the machine timer interrupt in Hz.
+*
+*  Return value
+*    == 0: O.K.
+*    != 0: Error, invalid frequency. Nothing was changed.
+*
+*  Additional information
+*    IntFreq must divide the machine timer frequency, otherwise the
+*    truncated reload value would let the embOS time drift. Either
+*    frequency must be a multiple of the other one, as OS_TICK_Config()
+*    handles integer ratios only.
+*    Reconfigures the machine timer compare value and informs embOS via
+*    OS_TIME_ConfigSysTimer() and OS_TICK_Config(). If TickFreq differs
+*    from IntFreq, ISR_M_Timer() uses OS_TICK_HandleEx() and tickless
+*    idle is not entered.
+*    Timeouts which are currently pending are not rescaled, and the
+*    values returned by OS_TIME_Get_us() may jump when the interrupt
+*    frequency is changed.
+*/
+int BSP_TICK_SetFreq(OS_U32 TickFreq, OS_U32 IntFreq) {
+  OS_U32 Reload;
+
+  if ((TickFreq == 0u) || (IntFreq == 0u) || (IntFreq > OS_TIMER_FREQ)) {
+    return -1;
+  }
+  if ((OS_TIMER_FREQ % IntFreq) != 0u) {
+    return -1;  // Reload would be truncated
+  }
+  if (((TickFreq % IntFreq) != 0u) && ((IntFreq % TickFreq) != 0u)) {
+    return -1;  // Ratio not representable by OS_TICK_Config()
+  }
+  Reload = OS_TIMER_FREQ / IntFreq;
+  OS_INT_IncDI();
+  _TimerReload            = Reload;
+  _IsFractionalTick       = (TickFreq != IntFreq) ? 1u : 0u;
+  _SysTimerConfig.IntFreq = IntFreq;
+  OS_TIME_ConfigSysTimer(&_SysTimerConfig);
+  OS_TICK_Config(TickFreq, IntFreq);
+  _TickCompare = MTIME + Reload;  // Restart the tick period with the new reload value
+  _UpdateCompare();
+  OS_INT_DecRI();
+  return 0;
+}
+
+/*********************************************************************
+*
+*       BSP_BOOT_GetStat()
+*
+*  Function description
+*    Returns the CPU cycles spent before and within OS_InitHW().
+*
+*  Additional information
+*    InitHWStart is the value of mcycle at the entry of OS_InitHW(),
+*    i.e. the cycles of the startup code, the initialization of
+*    variables and main() up to this call. InitHWStart + InitHWDuration
+*    therefore is the boot time up to OS_Start() when main() calls
+*    OS_Start() right after OS_InitHW(). Both values can be compared with
+*    and without ISR_TABLE_CONST.
+*/
+void BSP_BOOT_GetStat(BSP_BOOT_STAT* pStat) {
+  *pStat = _BootStat;
+}
+
+#if (DEADLINE_SERVICE != 0)
+/*********************************************************************
+*
+*       BSP_MTIMER_SetDeadline()
+*
+*  Function description
+*    Sets the machine timer value at which BSP_DEADLINE_Handle() shall
+*    be called next.
+*
+*  Parameters
+*    Compare: Absolute MTIME value of the earliest pending deadline, or
+*             BSP_MTIMER_NO_DEADLINE if none is pending.
+*
+*  Additional information
+*    Called by the deadline service with interrupts disabled. If the
+*    deadline already passed, the timer interrupt occurs immediately.
+*/
+void BSP_MTIMER_SetDeadline(OS_U64 Compare) {
+  _DeadlineCompare = Compare;
+  _UpdateCompare();
+}
+#endif
+
+#if (TICK_CATCHUP_BULK != 0)
+/*********************************************************************
+*
+*       BSP_TICK_GetNumCoalesced()
+*
+*  Function description
+*    Returns the number of missed system ticks which were accounted for
+*    in bulk by ISR_M_Timer() since OS_InitHW().
+*/
+OS_U32 BSP_TICK_GetNumCoalesced(void) {
+  return _NumCoalescedTicks;
+}
+#endif
+
+#if (TICK_STATISTICS != 0)
+/*********************************************************************
+*
+*       BSP_TICK_GetStat()
+*
+*  Function description
+*    Returns a consistent copy of the tick interrupt statistics.
+*
+*  Parameters
+*    pStat: Pointer to a structure which receives the statistics.
+*
+*  Additional information
+*    Latency is the time from the programmed compare value to the entry
+*    of ISR_M_Timer() in timer cycles (OS_TIMER_FREQ). Duration is the
+*    time spent in OS_TICK_Handle() per interrupt in CPU cycles.
+*/
+void BSP_TICK_GetStat(BSP_TICK_STAT* pStat) {
+  OS_INT_IncDI();
+  *pStat = _TickStat;
+  OS_INT_DecRI();
+  if (pStat->Latency.NumSamples != 0u) {
+    pStat->Latency.Mean = (OS_U32)(pStat->Latency.Sum / pStat->Latency.NumSamples);
+  }
+  if (pStat->Duration.NumSamples != 0u) {
+    pStat->Duration.Mean = (OS_U32)(pStat->Duration.Sum / pStat->Duration.NumSamples);
+  }
+}
+
+/*********************************************************************
+*
+*       BSP_TICK_ResetStat()
+*
+*  Function description
+*    Clears the tick interrupt statistics.
+*/
+void BSP_TICK_ResetStat(void) {
+  OS_INT_IncDI();
+  _ResetHistogram(&_TickStat.Latency);
+  _ResetHistogram(&_TickStat.Duration);
+  OS_INT_DecRI();
+}
+#endif
+
+#if (EXTEND_GLOBAL_ISR_CONTEXT != 0)
+/*********************************************************************
+*
+*       BSP_PLIC_InstallISR_Ex()
+*
+*  Function description
+*    Installs an interrupt handler with context for a global IRQ.
+*
+*  Parameters
+*    IRQIndex: Index of the global IRQ.
+*    pfISR:    Handler which receives pContext, NULL to uninstall.
+*    pContext: Context passed to pfISR, e.g. a driver instance.
+*
+*  Return value
+*    Previously installed handler with context, NULL if none.
+*
+*  Additional information
+*    Allows a single handler to serve several instances of a peripheral
+*    without one trampoline per instance. A handler installed here takes
+*    precedence over a handler installed via OS_PLIC_InstallISR() for
+*    the same IRQ. Without one, the IRQ is served by its default entry,
+*    which calls the handler installed via OS_PLIC_InstallISR().
+*/
+OS_IRQ_HANDLER_EX* BSP_PLIC_InstallISR_Ex(OS_U32 IRQIndex, OS_IRQ_HANDLER_EX* pfISR, void* pContext) {
+  OS_IRQ_HANDLER_EX* pfOldISR;
+
+  if (IRQIndex >= PLIC_NUM_INTERRUPTS) {
+    return NULL;
+  }
+  OS_INT_IncDI();
+  pfOldISR = (_IsDefaultISR_Ex(IRQIndex) != 0) ? NULL : _aPLIC_ISR_Ex[IRQIndex].pfISR;
+  if (pfISR != NULL) {
+    _aPLIC_ISR_Ex[IRQIndex].pfISR    = pfISR;
+    _aPLIC_ISR_Ex[IRQIndex].pContext = pContext;
+  } else {
+    _SetDefaultISR_Ex(IRQIndex);
+  }
+  OS_INT_DecRI();
+  return pfOldISR;
+}
+#endif
+
+#if (IRQ_STORM_DETECTION != 0)
+/*********************************************************************
+*
+*       BSP_PLIC_PollISR()
+*
+*  Function description
+*    Calls the handler of a global IRQ from task context.
+*
+*  Parameters
+*    IRQIndex: Index of the global IRQ.
+*
+*  Return value
+*    == 0: O.K.
+*    != 0: Error, invalid index or no handler installed.
+*
+*  Additional information
+*    Used to serve a masked IRQ by polling. The handler is called with
+*    interrupts disabled, as if it was called from ISR_M_External().
+*/
+int BSP_PLIC_PollISR(OS_U32 IRQIndex) {
+  if ((IRQIndex == 0u) || (IRQIndex >= PLIC_NUM_INTERRUPTS)) {
+    return -1;
+  }
+#if (EXTEND_GLOBAL_ISR_CONTEXT != 0)
+  if ((_IsDefaultISR_Ex(IRQIndex) != 0) && (PLIC_ISR(IRQIndex) == _ISR_NotInstalled)) {
+#else
+  if (PLIC_ISR(IRQIndex) == _ISR_NotInstalled) {
+#endif
+    return -1;
+  }
+  OS_INT_IncDI();
+  _CallISR(IRQIndex);
+  OS_INT_DecRI();
+  return 0;
+}
+#endif
+
+#if (INT_STACK != 0)
+/*********************************************************************
+*
+*       BSP_INTSTACK_GetSize()
+*
+*  Function description
+*    Returns the size of the interrupt stack in bytes.
+*/
+OS_U32 BSP_INTSTACK_GetSize(void) {
+  return (OS_U32)((OS_U8*)__stack_end__ - (OS_U8*)__stack_start__);
+}
+
+/*********************************************************************
+*
+*       BSP_INTSTACK_GetUsed()
+*
+*  Function description
+*    Returns the high-water mark of the interrupt stack in bytes.
+*
+*  Additional information
+*    The interrupt stack is the system stack, which is also used by
+*    main() before OS_Start(), by the embOS scheduler and by OS_Idle().
+*    The result includes their usage. If it equals
+*    BSP_INTSTACK_GetSize(), the stack probably overflowed.
+*/
+OS_U32 BSP_INTSTACK_GetUsed(void) {
+  const OS_U32* p;
+
+  p = __stack_start__;
+  while ((p < __stack_end__) && (*p == INT_STACK_FILL)) {
+    p++;
+  }
+  return (OS_U32)((const OS_U8*)__stack_end__ - (const OS_U8*)p);
+}
+#endif
+
+#if (PLIC_DRAIN_STATISTICS != 0)
+/*********************************************************************
+*
+*       BSP_PLIC_GetDrainStat()
+*
+*  Function description
+*    Returns a consistent copy of the ISR_M_External() statistics.
+*
+*  Additional information
+*    aServedPerEntry[n] counts the entries which served n global IRQs.
+*    aServedPerEntry[PLIC_MAX_CLAIMS_PER_ENTRY] therefore counts the
+*    entries which returned because of the bound. aServedPerEntry[0]
+*    counts entries without a pending IRQ, e.g. because it was served
+*    by the previous entry already.
+*/
+void BSP_PLIC_GetDrainStat(BSP_PLIC_DRAIN_STAT* pStat) {
+  OS_INT_IncDI();
+  *pStat = _DrainStat;
+  OS_INT_DecRI();
+}
+
+/*********************************************************************
+*
+*       BSP_PLIC_ResetDrainStat()
+*/
+void BSP_PLIC_ResetDrainStat(void) {
+  OS_U32 i;
+
+  OS_INT_IncDI();
+  _DrainStat.NumEntries = 0u;
+  _DrainStat.NumServed  = 0u;
+  for (i = 0u; i <= PLIC_MAX_CLAIMS_PER_ENTRY; i++) {
+    _DrainStat.aServedPerEntry[i] = 0u;
+  }
+  OS_INT_DecRI();
+}
+#endif
+
+#if (PLIC_NESTABLE != 0)
+/*********************************************************************
+*
+*       BSP_PLIC_GetNestStat()
+*
+*  Function description
+*    Returns a consistent copy of the nesting statistics of global IRQ
+*    handlers.
+*
+*  Additional information
+*    Intended for stress tests of PLIC_NESTABLE: with global IRQs of
+*    different priorities triggered at high rates, MaxDepth shows the
+*    nesting depth reached and NumOrderErrors must remain 0, as only
+*    IRQs of higher priority may preempt a handler.
+*/
+void BSP_PLIC_GetNestStat(BSP_PLIC_NEST_STAT* pStat) {
+  OS_INT_IncDI();
+  *pStat = _NestStat;
+  OS_INT_DecRI();
+}
+
+/*********************************************************************
+*
+*       BSP_PLIC_ResetNestStat()
+*/
+void BSP_PLIC_ResetNestStat(void) {
+  OS_INT_IncDI();
+  _NestStat.MaxDepth       = 0u;
+  _NestStat.NumNested      = 0u;
+  _NestStat.NumOrderErrors = 0u;
+  OS_INT_DecRI();
+}
+#endif
+
+#if (IRQ_STATISTICS != 0)
+/*********************************************************************
+*
+*       BSP_IRQ_GetCLINTStat()
+*
+*  Function description
+*    Returns a consistent copy of the statistics of a core-local
+*    interrupt.
+*
+*  Parameters
+*    IRQIndex: Interrupt cause, e.g. IRQ_M_TIMER.
+*    pStat:    Pointer to a structure which receives the statistics.
+*
+*  Return value
+*    == 0: O.K.
+*    != 0: Error, invalid index.
+*
+*  Additional information
+*    Latency is measured from the entry of OS_TrapHandler() to the call
+*    of the handler, duration until the handler returns, both in CPU
+*    cycles. The register save in trap_entry of the embOS library
+*    precedes OS_TrapHandler() and cannot be included. The latency of
+*    IRQ_M_TIMER is MTIME - MTIMECMP instead, which includes it. The duration includes OS_INT_Leave(): if the handler
+*    switches to another task, the sample also includes the time until
+*    the interrupted task resumes. Interrupts entered via vtrap_entry
+*    (CLINT_VECTORED_MODE) bypass OS_TrapHandler() and are not counted.
+*/
+int BSP_IRQ_GetCLINTStat(OS_U32 IRQIndex, BSP_IRQ_STAT* pStat) {
+  if (IRQIndex >= NUM_LOCAL_INTERRUPTS) {
+    return -1;
+  }
+  OS_INT_IncDI();
+  *pStat = _aCLINTStat[IRQIndex];
+  OS_INT_DecRI();
+  return 0;
+}
+
+/*********************************************************************
+*
+*       BSP_IRQ_GetPLICStat()
+*
+*  Function description
+*    Returns a consistent copy of the statistics of a global interrupt.
+*
+*  Parameters
+*    IRQIndex: Index of the global IRQ.
+*    pStat:    Pointer to a structure which receives the statistics.
+*
+*  Return value
+*    == 0: O.K.
+*    != 0: Error, invalid index.
+*
+*  Additional information
+*    Latency is measured from the entry of OS_TrapHandler() to the call
+*    of the handler, including claiming and serving IRQs of the same
+*    entry before. The register save in trap_entry of the embOS library
+*    cannot be included. With CLINT_VECTORED_MODE, OS_TrapHandler() is
+*    bypassed and latency is measured from ISR_M_External() entry. Duration is measured until the handler returns. Both
+*    are given in CPU cycles.
+*/
+int BSP_IRQ_GetPLICStat(OS_U32 IRQIndex, BSP_IRQ_STAT* pStat) {
+  if (IRQIndex >= PLIC_NUM_INTERRUPTS) {
+    return -1;
+  }
+  OS_INT_IncDI();
+  *pStat = _aPLICStat[IRQIndex];
+  OS_INT_DecRI();
+  return 0;
+}
+
+/*********************************************************************
+*
+*       BSP_IRQ_ResetStat()
+*
+*  Function description
+*    Clears the statistics of all interrupt sources.
+*/
+void BSP_IRQ_ResetStat(void) {
+  OS_U32 i;
+
+  OS_INT_IncDI();
+  for (i = 0u; i < NUM_LOCAL_INTERRUPTS; i++) {
+    _ResetIRQStat(&_aCLINTStat[i]);
+  }
+  for (i = 0u; i < PLIC_NUM_INTERRUPTS; i++) {
+    _ResetIRQStat(&_aPLICStat[i]);
+  }
+  OS_INT_DecRI();
+}
+#endif
+
+#if (IRQ_COUNTERS != 0)
+/*********************************************************************
+*
+*       BSP_IRQ_GetCounts()
+*
+*  Function description
+*    Takes a consistent snapshot of the occurrence counters of all
+*    interrupt sources.
+*
+*  Parameters
+*    pInfo:    Pointer to a structure which receives the time of the
+*              snapshot, the period it covers and the spurious and
+*              non-installed counts.
+*    paCLINT:  Array which receives the counters of the core-local
+*              interrupts, indexed by interrupt cause. May be NULL.
+*    NumCLINT: Number of elements of paCLINT.
+*    paPLIC:   Array which receives the counters of the global
+*              interrupts, indexed by IRQ index. May be NULL.
+*    NumPLIC:  Number of elements of paPLIC.
+*
+*  Additional information
+*    Counts are taken since the last call of BSP_IRQ_ResetCounts(), or
+*    since embOS was started. Rates are given in calls per second over
+*    this period, based on OS_TIME_Get_us64(). Arrays with fewer
+*    elements than the number of sources (16 + LOCAL_INT_COUNT
+*    core-local, PLIC_TOTAL_INTERRUPT_COUNT global) receive the first
+*    sources only, surplus elements are not written.
+*
+*    Core-local interrupts entered via vtrap_entry (CLINT_VECTORED_MODE)
+*    bypass OS_TrapHandler() and are not counted. A global IRQ which is
+*    claimed is counted once, even if it is deferred to ISR_M_Software()
+*    with ZERO_LATENCY_TIER enabled. Calls by BSP_PLIC_PollISR() are not
+*    counted.
+*/
+void BSP_IRQ_GetCounts(BSP_IRQ_COUNT_INFO* pInfo, BSP_IRQ_COUNT* paCLINT, OS_U32 NumCLINT, BSP_IRQ_COUNT* paPLIC, OS_U32 NumPLIC) {
+  OS_U64 ResetTime;
+
+  OS_INT_IncDI();
+  pInfo->Time_us         = OS_TIME_Get_us64();
+  pInfo->NumSpurious     = _NumSpurious;
+  pInfo->NumNotInstalled = _NumNotInstalled;
+  ResetTime              = _CntResetTime;
+  _CopyCounts(paCLINT, NumCLINT, _aCLINTCnt, NUM_LOCAL_INTERRUPTS);
+  _CopyCounts(paPLIC,  NumPLIC,  _aPLICCnt,  PLIC_NUM_INTERRUPTS);
+  OS_INT_DecRI();
+  pInfo->Period_us = pInfo->Time_us - ResetTime;
+  _CalcRates(paCLINT, NumCLINT, NUM_LOCAL_INTERRUPTS, pInfo->Period_us);
+  _CalcRates(paPLIC,  NumPLIC,  PLIC_NUM_INTERRUPTS,  pInfo->Period_us);
+}
+
+/*********************************************************************
+*
+*       BSP_IRQ_ResetCounts()
+*
+*  Function description
+*    Clears the occurrence counters of all interrupt sources and starts
+*    a new rate period.
+*/
+void BSP_IRQ_ResetCounts(void) {
+  OS_U32 i;
+
+  OS_INT_IncDI();
+  for (i = 0u; i < NUM_LOCAL_INTERRUPTS; i++) {
+    _aCLINTCnt[i] = 0u;
+  }
+  for (i = 0u; i < PLIC_NUM_INTERRUPTS; i++) {
+    _aPLICCnt[i] = 0u;
+  }
+  _NumSpurious     = 0u;
+  _NumNotInstalled = 0u;
+  _CntResetTime    = OS_TIME_Get_us64();
+  OS_INT_DecRI();
+}
+#endif
+
+#if (ZERO_LATENCY_TIER != 0)
+/*********************************************************************
+*
+*       BSP_PLIC_SetZeroLatency()
+*
+*  Function description
+*    Moves a global IRQ to or from the zero-latency tier.
+*
+*  Parameters
+*    IRQIndex: Index of the global IRQ.
+*    OnOff:    != 0: Serve at BSP_PLIC_ZL_PRIORITY without OS_INT_Enter().
+*              == 0: Serve at BSP_PLIC_EMBOS_MAX_PRIORITY as embOS ISR.
+*
+*  Return value
+*    == 0: O.K.
+*    != 0: Error, invalid index.
+*
+*  Additional information
+*    Handlers of zero-latency IRQs are not delayed by BSP_INT_DisableEmbOS(),
+*    e.g. in the heap lock of OS_ThreadSafe.c. They must not call any
+*    embOS API and must not access data which is protected by embOS
+*    critical sections only. Critical sections of the embOS library
+*    still disable all interrupts.
+*/
+int BSP_PLIC_SetZeroLatency(OS_U32 IRQIndex, OS_BOOL OnOff) {
+  if ((IRQIndex == 0u) || (IRQIndex >= PLIC_NUM_INTERRUPTS)) {
+    return -1;
+  }
+  OS_INT_IncDI();
+  _aIsZeroLatency[IRQIndex] = (OnOff != 0u) ? 1u : 0u;
+  (void)OS_PLIC_SetIntPriority(IRQIndex, (OnOff != 0u) ? BSP_PLIC_ZL_PRIORITY : BSP_PLIC_EMBOS_MAX_PRIORITY);
+  OS_INT_DecRI();
+  return 0;
+}
+
+/*********************************************************************
+*
+*       BSP_INT_DisableEmbOS()
+*
+*  Function description
+*    Disables all embOS-tier interrupts, but keeps zero-latency
+*    interrupts enabled.
+*
+*  Additional information
+*    Raises the PLIC threshold to BSP_PLIC_EMBOS_MAX_PRIORITY and masks
+*    the machine timer and software interrupts. May be nested, and must
+*    be paired with BSP_INT_EnableEmbOS(). In between, no embOS API may
+*    be called which could cause a task switch.
+*/
+void BSP_INT_DisableEmbOS(void) {
+  OS_U32 Status;
+
+  __asm volatile("csrrci %0, mstatus, 8" : "=r"(Status));  // Briefly disable all interrupts
+  if (_EmbOSDisableCnt == 0u) {
+    _EmbOSThreshold = PLIC_THRESHOLD;
+    PLIC_THRESHOLD  = BSP_PLIC_EMBOS_MAX_PRIORITY;
+    (void)PLIC_THRESHOLD;                                  // Read back, so that the threshold is effective before interrupts are enabled again
+    __asm volatile("csrrc %0, mie, %1" : "=r"(_EmbOSMIE) : "r"(MIE_EMBOS_MASK));
+  }
+  _EmbOSDisableCnt++;
+  __asm volatile("csrs mstatus, %0" : : "r"(Status & 8u));
+}
+
+/*********************************************************************
+*
+*       BSP_INT_EnableEmbOS()
+*
+*  Function description
+*    Restores embOS-tier interrupts disabled by BSP_INT_DisableEmbOS().
+*/
+void BSP_INT_EnableEmbOS(void) {
+  OS_U32 Status;
+
+  __asm volatile("csrrci %0, mstatus, 8" : "=r"(Status));
+  if (_EmbOSDisableCnt != 0u) {
+    _EmbOSDisableCnt--;
+    if (_EmbOSDisableCnt == 0u) {
+      PLIC_THRESHOLD = _EmbOSThreshold;
+      __asm volatile("csrs mie, %0" : : "r"(_EmbOSMIE & MIE_EMBOS_MASK));
+    }
+  }
+  __asm volatile("csrs mstatus, %0" : : "r"(Status & 8u));
+}
+#endif
+
 /*********************************************************************
 *
 *       Optional communication with embOSView
@@ -453,6 +2059,12 @@ void OS_Idle(void) {            // Idle loop: No task is ready to execute
 *
 *  Function description
 *    Sends one character.
+*
+*  Additional information
+*    With the UART, the character is queued in the TX ring of the
+*    driver. The TX interrupt calls OS_COM_OnTx() via _OS_OnTx() until
+*    the hardware FIFO is full, hence embOSView packets are sent in
+*    FIFO-sized bursts, see BSP_UART_GetStat().
 */
 void OS_COM_Send1(OS_U8 c) {
 #if   (OS_VIEW_IFSELECT == OS_VIEW_IF_JLINK)